@@ -11,10 +11,82 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+namespace
+{
+    /** Applies a gain to part of a single channel, used with processChannelsInParallel(). */
+    class GainChannelJob  : public AudioProcessorExt::ChannelJob
+    {
+    public:
+        GainChannelJob (AudioSampleBuffer& buffer_, int startSample_, int numSamples_, float gain_)
+            : buffer (buffer_), startSample (startSample_), numSamples (numSamples_), gain (gain_)
+        {
+        }
+
+        void processChunk (int channel)
+        {
+            buffer.applyGain (channel, startSample, numSamples, gain);
+        }
+
+    private:
+        AudioSampleBuffer& buffer;
+        const int startSample, numSamples;
+        const float gain;
+
+        JUCE_DECLARE_NON_COPYABLE (GainChannelJob);
+    };
+
+    /** The preset bank and current program are saved after the parameter state,
+        followed by this trailer. Older builds only read the parameter state and
+        ignore anything after it, and state from older builds has no trailer.
+    */
+    enum
+    {
+        bankTrailerMagic    = 0x54425050,   // 'PPBT' when read as bytes
+        bankTrailerSize     = 12            // uint32 current program, uint32 bank size, uint32 magic
+    };
+
+    void writeBankTrailer (char* const d, int currentProgram, size_t bankSize) noexcept
+    {
+        *(uint32*) d        = ByteOrder::swapIfBigEndian ((uint32) currentProgram);
+        *(uint32*) (d + 4)  = ByteOrder::swapIfBigEndian ((uint32) bankSize);
+        *(uint32*) (d + 8)  = ByteOrder::swapIfBigEndian ((uint32) bankTrailerMagic);
+    }
+
+    /** Returns the size of the bank before the trailer, or -1 if there isn't one. */
+    int readBankTrailer (const void* data, int sizeInBytes, int& currentProgram)
+    {
+        if (data == nullptr || sizeInBytes < (int) bankTrailerSize)
+            return -1;
+
+        const char* const d = static_cast<const char*> (data) + sizeInBytes - bankTrailerSize;
+
+        if (ByteOrder::littleEndianInt (d + 8) != (uint32) bankTrailerMagic)
+            return -1;
+
+        const uint32 bankSize = ByteOrder::littleEndianInt (d + 4);
+
+        if (bankSize > (uint32) (sizeInBytes - bankTrailerSize))
+            return -1;
+
+        currentProgram = (int) ByteOrder::littleEndianInt (d);
+        return (int) bankSize;
+    }
+}
 
 //==============================================================================
 PluginTestAudioProcessor::PluginTestAudioProcessor()
+    : parameterGroups (String::empty, 0, totalNumParams),
+      morphGroup (nullptr),
+      currentProgram (0),
+      lastMorphPosition (0.0f)
 {
+    // when bouncing offline use big blocks and spread the channels over the available cores
+    setOfflineRenderOptions (8192, SystemStats::getNumCpus());
+
+    // follow automation to the sample in hosts that can tell us where it belongs
+    setMaxNumScheduledParameterChanges (256);
+
     for (int i = 0; i < totalNumParams; i++)
     {
         parameters.add (new PluginParameter());
@@ -28,6 +100,49 @@ PluginTestAudioProcessor::PluginTestAudioProcessor()
                               5.0,				// max
                               1.0);				// default
 ;
+    parameters[param3]->init ("Morph",          // name
+                              UnitGeneric,		// unit
+                              "Morphs from the current program to the next",
+                              0.0,				// value
+                              0.0,				// min
+                              1.0,				// max
+                              0.0);				// default
+
+    // these are what the parameters are saved as, so keep them the same even
+    // if the names change
+    parameters[param0]->setIdentifier ("gain");
+    parameters[param1]->setIdentifier ("param1");
+    parameters[param2]->setIdentifier ("param2");
+    parameters[param3]->setIdentifier ("morph");
+    rebuildParameterIndex();
+
+    parameterGroups.addSubGroup ("output", param0, 1);
+    morphGroup = parameterGroups.addSubGroup ("morph", param3, 1);
+
+    // add any macros, links and constraints between parameters here
+    dependencies.setNumParameters (totalNumParams);
+    dependencies.build();
+
+    // the VST wrapper reads the number of programs as soon as we're created,
+    // so the bank needs to be set up here
+    presets.initialise (128, parameters);
+
+    // keep the last 1024 parameter changes for undo
+    setUndoHistorySize (1024);
+
+    // flags for the values that have been edited since the program was loaded
+    editedParameters.calloc (totalNumParams);
+
+    // parameters changed by their dependencies are sent to the host from here
+    pendingHostNotifications.calloc (totalNumParams);
+    startTimer (50);
+
+    morpher.prepare (parameters, 2);
+    morpher.setMorphable (param3, false);
+    updateMorphSources();
+
+    // make the first block pick up the starting morph position
+    morphGroup->markChanged();
 }
 
 PluginTestAudioProcessor::~PluginTestAudioProcessor()
@@ -53,6 +168,13 @@ float PluginTestAudioProcessor::getParameter (int index)
 void PluginTestAudioProcessor::setParameter (int index, float newValue)
 {
     parameters[index]->setNormalisedValue (newValue);
+    markEdited (index);
+    parameterValueChanged (index);
+}
+
+bool PluginTestAudioProcessor::isMetaParameter (int index) const
+{
+    return dependencies.isMetaParameter (index);
 }
 
 const String PluginTestAudioProcessor::getParameterName (int index)
@@ -62,7 +184,12 @@ const String PluginTestAudioProcessor::getParameterName (int index)
 
 const String PluginTestAudioProcessor::getParameterText (int index)
 {
-    return String (parameters[index]->getNormalisedValue(), 2);
+    return parameters[index]->getText();
+}
+
+void PluginTestAudioProcessor::getParameterTextUTF8 (int index, char* dest, int maxBytes)
+{
+    parameters[index]->copyTextUTF8 (dest, maxBytes);
 }
 
 const String PluginTestAudioProcessor::getInputChannelName (int channelIndex) const
@@ -112,6 +239,14 @@ float PluginTestAudioProcessor::getScaledParameter (int index)
 void PluginTestAudioProcessor::setScaledParameter (int index, float newValue)
 {
     parameters[index]->setValue (newValue);
+    markEdited (index);
+    parameterValueChanged (index);
+}
+
+void PluginTestAudioProcessor::parameterValueChanged (int index)
+{
+    parameterGroups.parameterChanged (index);
+    updateDependentParameters (index);
 }
 
 float PluginTestAudioProcessor::getParameterMin (int index)
@@ -129,28 +264,104 @@ float PluginTestAudioProcessor::getParameterDefault (int index)
     return parameters[index]->getDefault();
 }
 
+PluginParameter* PluginTestAudioProcessor::getPluginParameter (int index)
+{
+    return parameters[index];
+}
+
 //==============================================================================
 int PluginTestAudioProcessor::getNumPrograms()
 {
-    return 0;
+    return presets.getNumPresets();
 }
 
 int PluginTestAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void PluginTestAudioProcessor::setCurrentProgram (int index)
 {
+    if (isPositiveAndBelow (index, presets.getNumPresets()))
+    {
+        const ScopedLock sl (getCallbackLock());
+
+        // keep any edits made to the program we're leaving
+        finishPendingParameterState();
+        storeEditedParameters();
+
+        // the morph position is a performance control, so it stays where it is
+        const double morphPosition = parameters[param3]->getValue();
+
+        currentProgram = index;
+        presets.applyPreset (index, parameters);
+        parameters[param3]->setValue (morphPosition);
+
+        // morph the new program to the current position straight away
+        updateMorphSources();
+        lastMorphPosition = (float) morphPosition;
+        morpher.morphAlong (lastMorphPosition, parameters);
+
+        for (int i = 0; i < parameters.size(); ++i)
+            parameterValueChanged (i);
+    }
 }
 
 const String PluginTestAudioProcessor::getProgramName (int index)
 {
-    return String::empty;
+    return presets.getPresetName (index);
 }
 
 void PluginTestAudioProcessor::changeProgramName (int index, const String& newName)
 {
+    presets.setPresetName (index, newName);
+}
+
+void PluginTestAudioProcessor::markEdited (int index) noexcept
+{
+    // the morph position isn't part of a program
+    if (index != param3 && isPositiveAndBelow (index, (int) totalNumParams))
+        editedParameters[index] = 1;
+}
+
+void PluginTestAudioProcessor::storeEditedParameters()
+{
+    // only values set by the host or the user go back into the program. The
+    // live values of the others may be morph blends, and storing those would
+    // overwrite the program, which is also the morph's first source.
+    for (int i = 0; i < totalNumParams; ++i)
+        if (editedParameters[i].compareAndSetBool (0, 1))
+            presets.storePresetValue (currentProgram, i, parameters.getUnchecked (i)->getValue());
+}
+
+void PluginTestAudioProcessor::updateMorphSources()
+{
+    const int numPresets = presets.getNumPresets();
+
+    if (numPresets > 0)
+    {
+        morpher.setSource (0, presets.getPresetValues (currentProgram));
+        morpher.setSource (1, presets.getPresetValues ((currentProgram + 1) % numPresets));
+    }
+}
+
+void PluginTestAudioProcessor::updateDependentParameters (int index)
+{
+    dependencies.update (index, parameters, *this);
+}
+
+void PluginTestAudioProcessor::dependentParameterChanged (int index)
+{
+    // this can be on the audio thread, so the host is told later by timerCallback()
+    parameterGroups.parameterChanged (index);
+    pendingHostNotifications[index] = 1;
+}
+
+void PluginTestAudioProcessor::timerCallback()
+{
+    for (int i = 0; i < totalNumParams; ++i)
+        if (pendingHostNotifications[i].compareAndSetBool (0, 1))
+            sendParamChangeMessageToListeners (i, (float) parameters.getUnchecked (i)->getNormalisedValue());
 }
 
 //==============================================================================
@@ -168,6 +379,9 @@ void PluginTestAudioProcessor::releaseResources()
 
 void PluginTestAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
+    // pick up any state the host has restored since the last block
+    applyPendingParameterState();
+
     // This is the place where you'd normally do the guts of your plugin's
     // audio processing...
     for (int channel = 0; channel < getNumInputChannels(); ++channel)
@@ -177,8 +391,40 @@ void PluginTestAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuff
         // ..do something to the data...
     }
 
-    // just apply a gain for now
-    buffer.applyGain (0, buffer.getNumSamples(), parameters[param0]->getValue());
+    // just apply a gain for now, splitting the block wherever the host has
+    // scheduled a parameter change
+    const int numSamples = buffer.getNumSamples();
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int num = applyScheduledParameterChanges (pos, numSamples);
+
+        // morph from the current program towards the next one, but only look
+        // at the position when something has set it since the last check
+        const float morphPosition = morphGroup->checkAndClearChanged() ? (float) parameters[param3]->getValue()
+                                                                       : lastMorphPosition;
+
+        if (morphPosition != lastMorphPosition)
+        {
+            lastMorphPosition = morphPosition;
+            morpher.morphAlong (morphPosition, parameters);
+
+            // the blend replaces any edits, so there's nothing of the user's to keep
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                if (morpher.isMorphable (i))
+                {
+                    editedParameters[i] = 0;
+                    parameterValueChanged (i);
+                }
+            }
+        }
+
+        GainChannelJob gainJob (buffer, pos, num, (float) parameters[param0]->getValue());
+        processChannelsInParallel (gainJob, buffer.getNumChannels(), num);
+
+        pos += num;
+    }
     
     // In case we have more outputs than inputs, we'll clear any output
     // channels that didn't contain input data, (because these aren't
@@ -203,20 +449,60 @@ AudioProcessorEditor* PluginTestAudioProcessor::createEditor()
 //==============================================================================
 void PluginTestAudioProcessor::getStateInformation (MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // the values, the bank and its trailer are written straight into the
+    // host's block, which is sized once for all of them, so nothing else gets
+    // built or reallocated when the host autosaves
+    finishPendingParameterState();
+
+    const ScopedLock sl (getCallbackLock());
+
+    const size_t stateSize = PluginParameterState::getSizeNeeded (parameters.size());
+    const size_t bankSize = presets.getSizeInBytes();
+
+    destData.setSize (stateSize + bankSize + bankTrailerSize);
+    char* const d = static_cast<char*> (destData.getData());
+
+    PluginParameterState::writeTo (parameters, d);
+    presets.writeTo (d + stateSize);
+    writeBankTrailer (d + stateSize + bankSize, currentProgram, bankSize);
 }
 
 void PluginTestAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    int savedProgram = 0;
+    const int bankSize = readBankTrailer (data, sizeInBytes, savedProgram);
+
+    if (bankSize >= 0)
+    {
+        sizeInBytes -= bankTrailerSize + bankSize;
+
+        // the bank is decoded before taking the lock, so the audio thread only
+        // ever waits for it to be swapped in
+        PluginPresetBank newPresets;
+
+        if (newPresets.loadFromData (static_cast<const char*> (data) + sizeInBytes, bankSize, parameters))
+        {
+            const ScopedLock sl (getCallbackLock());
+
+            presets.swapWith (newPresets);
+            currentProgram = isPositiveAndBelow (savedProgram, presets.getNumPresets()) ? savedProgram : 0;
+
+            for (int i = 0; i < totalNumParams; ++i)
+                editedParameters[i] = 0;
+
+            updateMorphSources();
+        }
+    }
+
+    // the values are decoded in the background and swapped in at the start of
+    // the next block, so a running instance never sees half of the new state
+    setParametersFromBinaryAsync (data, sizeInBytes);
 }
 
 //==============================================================================
 // This creates new instances of the plugin..
-AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+// The wrappers declare this as returning an AudioProcessorExt, so it must match.
+AudioProcessorExt* JUCE_CALLTYPE createPluginFilter()
 {
     return new PluginTestAudioProcessor();
 }
@@ -14,11 +14,17 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "juce_AudioProcessorExt.h"
 #include "juce_PluginParameter.h"
+#include "juce_PluginParameterGroup.h"
+#include "juce_PluginParameterGraph.h"
+#include "juce_PluginPresetBank.h"
+#include "juce_PluginPresetMorpher.h"
 
 //==============================================================================
 /**
 */
-class PluginTestAudioProcessor  : public AudioProcessorExt
+class PluginTestAudioProcessor  : public AudioProcessorExt,
+                                  private PluginParameterGraph::Callback,
+                                  private Timer
 {
 public:
     //==============================================================================
@@ -43,8 +49,11 @@ public:
     float getParameter (int index);
     void setParameter (int index, float newValue);
 
+    bool isMetaParameter (int index) const;
+
     const String getParameterName (int index);
     const String getParameterText (int index);
+    void getParameterTextUTF8 (int index, char* dest, int maxBytes);
 
     const String getInputChannelName (int channelIndex) const;
     const String getOutputChannelName (int channelIndex) const;
@@ -65,6 +74,10 @@ public:
     
     float getParameterDefault (int index);
     
+    PluginParameter* getPluginParameter (int index);
+
+    void parameterValueChanged (int index);
+
     //==============================================================================
     int getNumPrograms();
     int getCurrentProgram();
@@ -81,12 +94,30 @@ public:
         param0,
         param1,
         param2,
+        // the morph position goes after the original parameters, so any
+        // automation hosts have saved for those keeps the same indexes
+        param3,
         totalNumParams
     };
     
 private:
     //==============================================================================
     OwnedArray<PluginParameter> parameters;
+    PluginParameterGroup parameterGroups;
+    PluginParameterGroup* morphGroup;
+    PluginParameterGraph dependencies;
+    PluginPresetBank presets;
+    int currentProgram;
+    PluginPresetMorpher morpher;
+    float lastMorphPosition;
+    HeapBlock<Atomic<int> > editedParameters, pendingHostNotifications;
+
+    void markEdited (int index) noexcept;
+    void storeEditedParameters();
+    void updateMorphSources();
+    void updateDependentParameters (int index);
+    void dependentParameterChanged (int index);
+    void timerCallback();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginTestAudioProcessor);
 };
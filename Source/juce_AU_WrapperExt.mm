@@ -80,6 +80,8 @@
 
 //***
 #include "juce_AudioProcessorExt.h"
+#include "juce_AudioInterleaving.h"
+#include "juce_MidiEventFifo.h"
 
 //==============================================================================
 #define juceFilterObjectPropertyID 0x1a45ffe9
@@ -415,6 +417,10 @@ public:
             if (juceFilter->isMetaParameter (index))
                 outParameterInfo.flags |= kAudioUnitParameterFlag_IsGlobalMeta;
 
+            //*** ramps can only be followed if the filter splits its blocks at them
+            if (juceFilter->canScheduleParameterChanges())
+                outParameterInfo.flags |= kAudioUnitParameterFlag_CanRamp;
+
             AUBase::FillInParameterName (outParameterInfo, name.toCFString(), false);
 
 //            outParameterInfo.minValue = 0.0f;
@@ -461,14 +467,51 @@ public:
         if (inScope == kAudioUnitScope_Global && juceFilter != nullptr)
         {
 //            juceFilter->setParameter ((int) inID, inValue);
-            //***
-            juceFilter->setScaledParameter ((int) inID, inValue);
+            //*** changes for later in the block are queued for the filter to pick
+            // up at the right sample, if it can
+            if (inBufferOffsetInFrames == 0
+                 || ! juceFilter->scheduleParameterChange ((int) inID, inValue, (int) inBufferOffsetInFrames))
+                juceFilter->setScaledParameter ((int) inID, inValue);
+
             return noErr;
         }
 
         return AUBase::SetParameter (inID, inScope, inElement, inValue, inBufferOffsetInFrames);
     }
 
+    //***
+    ComponentResult ScheduleParameter (const AudioUnitParameterEvent* inParameterEvent,
+                                       UInt32 inNumEvents)
+    {
+        for (UInt32 i = 0; i < inNumEvents; ++i)
+        {
+            const AudioUnitParameterEvent& e = inParameterEvent[i];
+
+            if (e.scope != kAudioUnitScope_Global || juceFilter == nullptr)
+            {
+                AUBase::ScheduleParameter (&e, 1);
+            }
+            else if (e.eventType == kParameterEvent_Ramped)
+            {
+                // if the ramp can't be queued, just jump to where it ends
+                if (! juceFilter->scheduleParameterRamp ((int) e.parameter,
+                                                         e.eventValues.ramp.startValue,
+                                                         e.eventValues.ramp.endValue,
+                                                         (int) e.eventValues.ramp.startBufferOffset,
+                                                         (int) e.eventValues.ramp.durationInFrames))
+                    juceFilter->setScaledParameter ((int) e.parameter, e.eventValues.ramp.endValue);
+            }
+            else
+            {
+                SetParameter (e.parameter, e.scope, e.element,
+                              e.eventValues.immediate.value,
+                              e.eventValues.immediate.bufferOffset);
+            }
+        }
+
+        return noErr;
+    }
+
     //==============================================================================
     ComponentResult Version()                   { return JucePlugin_VersionCode; }
     bool SupportsTail()                         { return true; }
@@ -671,9 +714,8 @@ public:
 
             juceFilter->prepareToPlay (GetSampleRate(), GetMaxFramesPerSlice());
 
-            midiEvents.ensureSize (2048);
+            midiEvents.ensureSize (incomingEvents.getMaxBufferSizeNeeded());   //*** room for a full FIFO
             midiEvents.clear();
-            incomingEvents.ensureSize (2048);
             incomingEvents.clear();
 
             channels.calloc (jmax (juceFilter->getNumInputChannels(),
@@ -754,39 +796,28 @@ public:
                 else
                 {
                     // need to de-interleave..
+                    const int firstChan = numInChans;
+
                     for (unsigned int subChan = 0; subChan < buf.mNumberChannels && numInChans < numIn; ++subChan)
                     {
-                        float* dest;
-
-                        if (numInChans < numOutChans)
-                        {
-                            dest = channels [numInChans++];
-                        }
-                        else
-                        {
-                            dest = bufferSpace.getSampleData (nextSpareBufferChan++);
-                            channels [numInChans++] = dest;
-                        }
-
-                        const float* src = ((const float*) buf.mData) + subChan;
-
-                        for (int j = numSamples; --j >= 0;)
-                        {
-                            *dest++ = *src;
-                            src += buf.mNumberChannels;
-                        }
+                        if (numInChans >= numOutChans)
+                            channels [numInChans] = bufferSpace.getSampleData (nextSpareBufferChan++);
+
+                        ++numInChans;
                     }
+
+                    //*** do all the channels in this buffer in one pass
+                    AudioInterleaving::deinterleave ((const float*) buf.mData, (int) buf.mNumberChannels,
+                                                     channels + firstChan, numInChans - firstChan, (int) numSamples);
                 }
 
                 if (numInChans >= numIn)
                     break;
             }
 
-            {
-                const ScopedLock sl (incomingMidiLock);
-                midiEvents.clear();
-                incomingEvents.swapWith (midiEvents);
-            }
+            //*** pick up the events the host has sent since the last block, without locking
+            midiEvents.clear();
+            incomingEvents.popAll (midiEvents, (int) numSamples);
 
             {
                 AudioSampleBuffer buffer (channels, jmax (numIn, numOut), numSamples);
@@ -839,17 +870,12 @@ public:
 
                     if (buf.mNumberChannels > 1)
                     {
-                        for (unsigned int subChan = 0; subChan < buf.mNumberChannels; ++subChan)
-                        {
-                            const float* src = bufferSpace.getSampleData (nextSpareBufferChan++);
-                            float* dest = ((float*) buf.mData) + subChan;
-
-                            for (int j = numSamples; --j >= 0;)
-                            {
-                                *dest = *src++;
-                                dest += buf.mNumberChannels;
-                            }
-                        }
+                        //*** do all the channels in this buffer in one pass
+                        AudioInterleaving::interleave (bufferSpace.getArrayOfChannels() + nextSpareBufferChan,
+                                                       (int) buf.mNumberChannels, (float*) buf.mData,
+                                                       (int) buf.mNumberChannels, (int) numSamples);
+
+                        nextSpareBufferChan += (int) buf.mNumberChannels;
                     }
                 }
             }
@@ -871,12 +897,11 @@ protected:
                              #endif
     {
        #if JucePlugin_WantsMidiInput
-        const ScopedLock sl (incomingMidiLock);
         const juce::uint8 data[] = { (juce::uint8) (nStatus | inChannel),
                                      (juce::uint8) inData1,
                                      (juce::uint8) inData2 };
 
-        incomingEvents.addEvent (data, 3, inStartFrame);
+        incomingEvents.push (data, 3, (int) inStartFrame);
        #endif
 
         return noErr;
@@ -885,8 +910,7 @@ protected:
     OSStatus HandleSysEx (const UInt8* inData, UInt32 inLength)
     {
        #if JucePlugin_WantsMidiInput
-        const ScopedLock sl (incomingMidiLock);
-        incomingEvents.addEvent (inData, inLength, 0);
+        incomingEvents.push (inData, (int) inLength, 0);
        #endif
         return noErr;
     }
@@ -951,13 +975,13 @@ private:
     ScopedPointer<AudioProcessorExt> juceFilter;
     AudioSampleBuffer bufferSpace;
     HeapBlock <float*> channels;
-    MidiBuffer midiEvents, incomingEvents;
+    MidiBuffer midiEvents;
+    MidiEventFifo incomingEvents;   //*** filled by the host's MIDI thread, emptied by the render thread
     bool prepared;
     SMPTETime lastSMPTETime;
     AUChannelInfo channelInfo [numChannelConfigs];
     AudioUnitEvent auEvent;
     mutable juce::MemoryBlock presetsArray;
-    CriticalSection incomingMidiLock;
 
     JUCE_DECLARE_NON_COPYABLE (JuceAU);
 };
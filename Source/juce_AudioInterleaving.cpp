@@ -0,0 +1,343 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_AudioInterleaving.h"
+
+#if defined (__SSE__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 1)
+ #define JUCE_INTERLEAVING_USE_SSE 1
+ #include <xmmintrin.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+ #define JUCE_INTERLEAVING_USE_NEON 1
+ #include <arm_neon.h>
+#endif
+
+namespace AudioInterleavingHelpers
+{
+    //==============================================================================
+    template <bool adding>
+    void interleaveScalar (const float* const* source, const int numChannels, float* dest,
+                           const int numDestChannels, const int startSample, const int numSamples) noexcept
+    {
+        dest += startSample * numDestChannels;
+
+        for (int i = startSample; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                if (adding)
+                    dest[c] += source[c][i];
+                else
+                    dest[c] = source[c][i];
+            }
+
+            dest += numDestChannels;
+        }
+    }
+
+    void deinterleaveScalar (const float* source, const int numSourceChannels, float* const* dest,
+                             const int numChannels, const int startSample, const int numSamples) noexcept
+    {
+        source += startSample * numSourceChannels;
+
+        for (int i = startSample; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+                dest[c][i] = source[c];
+
+            source += numSourceChannels;
+        }
+    }
+
+    //==============================================================================
+   #if JUCE_INTERLEAVING_USE_SSE
+    template <bool adding>
+    inline void storeFrames (float* dest, const __m128 v) noexcept
+    {
+        _mm_storeu_ps (dest, adding ? _mm_add_ps (_mm_loadu_ps (dest), v) : v);
+    }
+
+    /** Converts four frames at a time and returns the number of samples done. */
+    int deinterleaveVector (const float* src, const int numChannels, float* const* dest, const int numSamples) noexcept
+    {
+        const int numVectorSamples = numSamples & ~3;
+
+        switch (numChannels)
+        {
+            case 2:
+                for (int i = 0; i < numVectorSamples; i += 4, src += 8)
+                {
+                    const __m128 a = _mm_loadu_ps (src);
+                    const __m128 b = _mm_loadu_ps (src + 4);
+                    _mm_storeu_ps (dest[0] + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+                    _mm_storeu_ps (dest[1] + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+                }
+                return numVectorSamples;
+
+            case 4:
+                for (int i = 0; i < numVectorSamples; i += 4, src += 16)
+                {
+                    __m128 r0 = _mm_loadu_ps (src),     r1 = _mm_loadu_ps (src + 4);
+                    __m128 r2 = _mm_loadu_ps (src + 8), r3 = _mm_loadu_ps (src + 12);
+                    _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                    _mm_storeu_ps (dest[0] + i, r0);
+                    _mm_storeu_ps (dest[1] + i, r1);
+                    _mm_storeu_ps (dest[2] + i, r2);
+                    _mm_storeu_ps (dest[3] + i, r3);
+                }
+                return numVectorSamples;
+
+            case 8:
+                for (int i = 0; i < numVectorSamples; i += 4, src += 32)
+                {
+                    for (int half = 0; half < 2; ++half)
+                    {
+                        const float* const s = src + half * 4;
+                        __m128 r0 = _mm_loadu_ps (s),      r1 = _mm_loadu_ps (s + 8);
+                        __m128 r2 = _mm_loadu_ps (s + 16), r3 = _mm_loadu_ps (s + 24);
+                        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                        float* const* const d = dest + half * 4;
+                        _mm_storeu_ps (d[0] + i, r0);
+                        _mm_storeu_ps (d[1] + i, r1);
+                        _mm_storeu_ps (d[2] + i, r2);
+                        _mm_storeu_ps (d[3] + i, r3);
+                    }
+                }
+                return numVectorSamples;
+
+            default:
+                return 0;
+        }
+    }
+
+    template <bool adding>
+    int interleaveVector (const float* const* source, const int numChannels, float* dst, const int numSamples) noexcept
+    {
+        const int numVectorSamples = numSamples & ~3;
+
+        switch (numChannels)
+        {
+            case 1:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 4)
+                    storeFrames<adding> (dst, _mm_loadu_ps (source[0] + i));
+                return numVectorSamples;
+
+            case 2:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 8)
+                {
+                    const __m128 l = _mm_loadu_ps (source[0] + i);
+                    const __m128 r = _mm_loadu_ps (source[1] + i);
+                    storeFrames<adding> (dst,     _mm_unpacklo_ps (l, r));
+                    storeFrames<adding> (dst + 4, _mm_unpackhi_ps (l, r));
+                }
+                return numVectorSamples;
+
+            case 4:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 16)
+                {
+                    __m128 r0 = _mm_loadu_ps (source[0] + i), r1 = _mm_loadu_ps (source[1] + i);
+                    __m128 r2 = _mm_loadu_ps (source[2] + i), r3 = _mm_loadu_ps (source[3] + i);
+                    _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                    storeFrames<adding> (dst,      r0);
+                    storeFrames<adding> (dst + 4,  r1);
+                    storeFrames<adding> (dst + 8,  r2);
+                    storeFrames<adding> (dst + 12, r3);
+                }
+                return numVectorSamples;
+
+            case 8:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 32)
+                {
+                    for (int half = 0; half < 2; ++half)
+                    {
+                        const float* const* const s = source + half * 4;
+                        __m128 r0 = _mm_loadu_ps (s[0] + i), r1 = _mm_loadu_ps (s[1] + i);
+                        __m128 r2 = _mm_loadu_ps (s[2] + i), r3 = _mm_loadu_ps (s[3] + i);
+                        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                        float* const d = dst + half * 4;
+                        storeFrames<adding> (d,      r0);
+                        storeFrames<adding> (d + 8,  r1);
+                        storeFrames<adding> (d + 16, r2);
+                        storeFrames<adding> (d + 24, r3);
+                    }
+                }
+                return numVectorSamples;
+
+            default:
+                return 0;
+        }
+    }
+
+    //==============================================================================
+   #elif JUCE_INTERLEAVING_USE_NEON
+    int deinterleaveVector (const float* src, const int numChannels, float* const* dest, const int numSamples) noexcept
+    {
+        const int numVectorSamples = numSamples & ~3;
+
+        switch (numChannels)
+        {
+            case 2:
+                for (int i = 0; i < numVectorSamples; i += 4, src += 8)
+                {
+                    const float32x4x2_t v = vld2q_f32 (src);
+                    vst1q_f32 (dest[0] + i, v.val[0]);
+                    vst1q_f32 (dest[1] + i, v.val[1]);
+                }
+                return numVectorSamples;
+
+            case 4:
+                for (int i = 0; i < numVectorSamples; i += 4, src += 16)
+                {
+                    const float32x4x4_t v = vld4q_f32 (src);
+                    vst1q_f32 (dest[0] + i, v.val[0]);
+                    vst1q_f32 (dest[1] + i, v.val[1]);
+                    vst1q_f32 (dest[2] + i, v.val[2]);
+                    vst1q_f32 (dest[3] + i, v.val[3]);
+                }
+                return numVectorSamples;
+
+            default:
+                return 0;
+        }
+    }
+
+    template <bool adding>
+    int interleaveVector (const float* const* source, const int numChannels, float* dst, const int numSamples) noexcept
+    {
+        const int numVectorSamples = numSamples & ~3;
+
+        switch (numChannels)
+        {
+            case 1:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 4)
+                {
+                    const float32x4_t v = vld1q_f32 (source[0] + i);
+                    vst1q_f32 (dst, adding ? vaddq_f32 (v, vld1q_f32 (dst)) : v);
+                }
+                return numVectorSamples;
+
+            case 2:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 8)
+                {
+                    float32x4x2_t v;
+                    v.val[0] = vld1q_f32 (source[0] + i);
+                    v.val[1] = vld1q_f32 (source[1] + i);
+
+                    if (adding)
+                    {
+                        const float32x4x2_t existing = vld2q_f32 (dst);
+                        v.val[0] = vaddq_f32 (v.val[0], existing.val[0]);
+                        v.val[1] = vaddq_f32 (v.val[1], existing.val[1]);
+                    }
+
+                    vst2q_f32 (dst, v);
+                }
+                return numVectorSamples;
+
+            case 4:
+                for (int i = 0; i < numVectorSamples; i += 4, dst += 16)
+                {
+                    float32x4x4_t v;
+
+                    for (int c = 0; c < 4; ++c)
+                        v.val[c] = vld1q_f32 (source[c] + i);
+
+                    if (adding)
+                    {
+                        const float32x4x4_t existing = vld4q_f32 (dst);
+
+                        for (int c = 0; c < 4; ++c)
+                            v.val[c] = vaddq_f32 (v.val[c], existing.val[c]);
+                    }
+
+                    vst4q_f32 (dst, v);
+                }
+                return numVectorSamples;
+
+            default:
+                return 0;
+        }
+    }
+
+    //==============================================================================
+   #else
+    inline int deinterleaveVector (const float*, int, float* const*, int) noexcept   { return 0; }
+
+    template <bool adding>
+    inline int interleaveVector (const float* const*, int, float*, int) noexcept     { return 0; }
+   #endif
+}
+
+//==============================================================================
+void AudioInterleaving::deinterleave (const float* source, const int numSourceChannels,
+                                      float* const* destChannels, const int numChannels, const int numSamples) noexcept
+{
+    using namespace AudioInterleavingHelpers;
+    jassert (numChannels <= numSourceChannels);
+
+    if (numChannels == 1 && numSourceChannels == 1)
+    {
+        memcpy (destChannels[0], source, sizeof (float) * (size_t) numSamples);
+        return;
+    }
+
+    // the vector versions only work when every channel in the frame is used
+    const int numDone = (numChannels == numSourceChannels) ? deinterleaveVector (source, numChannels, destChannels, numSamples)
+                                                           : 0;
+
+    deinterleaveScalar (source, numSourceChannels, destChannels, numChannels, numDone, numSamples);
+}
+
+void AudioInterleaving::interleave (const float* const* sourceChannels, const int numChannels,
+                                    float* dest, const int numDestChannels, const int numSamples) noexcept
+{
+    using namespace AudioInterleavingHelpers;
+    jassert (numChannels <= numDestChannels);
+
+    if (numChannels == 1 && numDestChannels == 1)
+    {
+        memcpy (dest, sourceChannels[0], sizeof (float) * (size_t) numSamples);
+        return;
+    }
+
+    const int numDone = (numChannels == numDestChannels) ? interleaveVector<false> (sourceChannels, numChannels, dest, numSamples)
+                                                         : 0;
+
+    interleaveScalar<false> (sourceChannels, numChannels, dest, numDestChannels, numDone, numSamples);
+}
+
+void AudioInterleaving::interleaveAdding (const float* const* sourceChannels, const int numChannels,
+                                          float* dest, const int numDestChannels, const int numSamples) noexcept
+{
+    using namespace AudioInterleavingHelpers;
+    jassert (numChannels <= numDestChannels);
+
+    const int numDone = (numChannels == numDestChannels) ? interleaveVector<true> (sourceChannels, numChannels, dest, numSamples)
+                                                         : 0;
+
+    interleaveScalar<true> (sourceChannels, numChannels, dest, numDestChannels, numDone, numSamples);
+}
+
+//END_JUCE_NAMESPACE
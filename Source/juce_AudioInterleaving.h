@@ -0,0 +1,68 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_AUDIOINTERLEAVING_JUCEHEADER__
+#define __JUCE_AUDIOINTERLEAVING_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Converts between interleaved audio, as some hosts supply it, and the
+    separate channels an AudioSampleBuffer uses.
+
+    Each function goes through the interleaved data once, handling all the
+    channels together rather than making a strided pass for each one. Stereo,
+    quad and 8-channel data use SSE on Intel and NEON on ARM, working on four
+    frames at a time, as does interleaveAdding() with a single channel, which
+    is just a vector add; other channel counts, and builds without either, use a
+    plain loop. The interleaved data doesn't need to be aligned.
+
+    numChannels is the number of channels to convert, which can be less than
+    the number in each interleaved frame, e.g. if a host sends more channels
+    than the plugin uses.
+ */
+class AudioInterleaving
+{
+public:
+    //==============================================================================
+    /** Splits interleaved data into separate channels. */
+    static void deinterleave (const float* source, int numSourceChannels,
+                              float* const* destChannels, int numChannels, int numSamples) noexcept;
+
+    /** Interleaves some separate channels, replacing what's in the destination. */
+    static void interleave (const float* const* sourceChannels, int numChannels,
+                            float* dest, int numDestChannels, int numSamples) noexcept;
+
+    /** Interleaves some separate channels, adding them to what's in the destination. */
+    static void interleaveAdding (const float* const* sourceChannels, int numChannels,
+                                  float* dest, int numDestChannels, int numSamples) noexcept;
+
+private:
+    AudioInterleaving();
+    JUCE_DECLARE_NON_COPYABLE (AudioInterleaving);
+};
+
+#endif //__JUCE_AUDIOINTERLEAVING_JUCEHEADER__
@@ -27,6 +27,170 @@
 
 //***BEGIN_JUCE_NAMESPACE
 
+//==============================================================================
+//***
+/** One background thread shared by every processor in the process, used to
+    decode restored state. Hosts loading a big session restore hundreds of
+    instances at once, so this keeps it to a single extra thread.
+*/
+class SharedStateRestoreThread  : public TimeSliceThread
+{
+public:
+    static SharedStateRestoreThread* retain()
+    {
+        const ScopedLock sl (getLock());
+
+        if (numUsers++ == 0)
+        {
+            instance = new SharedStateRestoreThread();
+            instance->startThread (3);
+        }
+
+        return instance;
+    }
+
+    static void release()
+    {
+        const ScopedLock sl (getLock());
+
+        if (--numUsers == 0)
+        {
+            delete instance;
+            instance = nullptr;
+        }
+    }
+
+private:
+    SharedStateRestoreThread()
+        : TimeSliceThread ("Plugin State Restore")
+    {
+    }
+
+    ~SharedStateRestoreThread()
+    {
+        stopThread (4000);
+    }
+
+    static CriticalSection& getLock()
+    {
+        static CriticalSection lock;
+        return lock;
+    }
+
+    static SharedStateRestoreThread* instance;
+    static int numUsers;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedStateRestoreThread);
+};
+
+SharedStateRestoreThread* SharedStateRestoreThread::instance = nullptr;
+int SharedStateRestoreThread::numUsers = 0;
+
+//==============================================================================
+/** Holds one processor's state while it's decoded into a frame and then
+    handed to the audio thread.
+
+    The frame is passed between threads using frameState: the decoder only
+    writes to it when it's idle (or ready but not yet picked up, in which case
+    the newer state wins), and the audio thread only reads it once it's ready.
+*/
+class AudioProcessorExt::StateRestorer  : public TimeSliceClient
+{
+public:
+    StateRestorer()
+        : thread (SharedStateRestoreThread::retain()),
+          index (nullptr),
+          numParameters (0),
+          hasPendingData (false),
+          frameState (frameIdle)
+    {
+        thread->addTimeSliceClient (this);
+    }
+
+    ~StateRestorer()
+    {
+        thread->removeTimeSliceClient (this);
+        SharedStateRestoreThread::release();
+    }
+
+    void decodeAsync (const void* data, int sizeInBytes, int numParameters_,
+                      const PluginParameterIndex& index_)
+    {
+        {
+            const ScopedLock sl (decodeLock);
+            pendingData.replaceWith (data, (size_t) sizeInBytes);
+            numParameters = numParameters_;
+            index = &index_;
+            hasPendingData = true;
+        }
+
+        thread->moveToFrontOfQueue (this);
+    }
+
+    /** Decodes any waiting data on the calling thread. */
+    void decodeNow()
+    {
+        const ScopedLock sl (decodeLock);
+        decodePendingData();
+    }
+
+    /** Applies the frame if one is ready. This is safe to call on the audio thread. */
+    void applyIfReady (AudioProcessorExt& owner)
+    {
+        if (frameState.compareAndSetBool (frameApplying, frameReady))
+        {
+            owner.applyParameterFrame (frame);
+            frameState = frameIdle;
+        }
+    }
+
+    int useTimeSlice()
+    {
+        const ScopedLock sl (decodeLock);
+
+        // if the audio thread is busy with the last frame, try again shortly
+        return decodePendingData() ? 500 : 1;
+    }
+
+private:
+    enum
+    {
+        frameIdle,
+        frameDecoding,
+        frameReady,
+        frameApplying
+    };
+
+    SharedStateRestoreThread* thread;
+    CriticalSection decodeLock;
+    juce::MemoryBlock pendingData;
+    const PluginParameterIndex* index;
+    int numParameters;
+    bool hasPendingData;
+    PluginParameterFrame frame;
+    Atomic<int> frameState;
+
+    bool decodePendingData()
+    {
+        if (! hasPendingData)
+            return true;
+
+        if (! (frameState.compareAndSetBool (frameDecoding, frameIdle)
+                || frameState.compareAndSetBool (frameDecoding, frameReady)))
+            return false;
+
+        hasPendingData = false;
+        frame.setNumParameters (numParameters);
+
+        const bool decodedOk = PluginParameterState::read (pendingData.getData(), (int) pendingData.getSize(),
+                                                           frame, *index);
+        frameState = decodedOk ? frameReady : frameIdle;
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (StateRestorer);
+};
+
 //==============================================================================
 AudioProcessorExt::AudioProcessorExt()
     : playHead (nullptr),
@@ -36,7 +200,11 @@ AudioProcessorExt::AudioProcessorExt()
       numOutputChannels (0),
       latencySamples (0),
       suspended (false),
-      nonRealtime (false)
+      nonRealtime (false),
+      offlineBlockSize (0),
+      maxNumRenderThreads (1),
+      minBlockSizeForThreads (0),
+      smoothsGainsOnRestore (true)
 {
 }
 
@@ -83,7 +251,60 @@ void AudioProcessorExt::setPlayConfigDetails (const int numIns,
 
 void AudioProcessorExt::setNonRealtime (const bool nonRealtime_) noexcept
 {
-    nonRealtime = nonRealtime_;
+    if (nonRealtime != nonRealtime_)
+    {
+        nonRealtime = nonRealtime_;
+        nonRealtimeStateChanged();
+    }
+}
+
+void AudioProcessorExt::setOfflineRenderOptions (const int offlineBlockSize_, const int maxNumThreads,
+                                                 const int minBlockSizeForThreads_)
+{
+    jassert (maxNumThreads > 0);
+
+    offlineBlockSize = offlineBlockSize_;
+    minBlockSizeForThreads = minBlockSizeForThreads_;
+
+    if (maxNumRenderThreads != maxNumThreads)
+    {
+        maxNumRenderThreads = jmax (1, maxNumThreads);
+
+        // the pool is made here rather than in setNonRealtime(), which hosts can call
+        // on the audio thread, and its threads just wait until there's offline work
+        RenderThreadPool* const newPool = (maxNumRenderThreads > 1) ? new RenderThreadPool (maxNumRenderThreads - 1)
+                                                                    : nullptr;
+
+        ScopedPointer<RenderThreadPool> oldPool;
+
+        {
+            const ScopedLock sl (callbackLock);
+            oldPool = renderThreadPool.release();
+            renderThreadPool = newPool;
+        }
+    }
+}
+
+int AudioProcessorExt::getInternalBlockSize() const noexcept
+{
+    return nonRealtime ? jmax (blockSize, offlineBlockSize) : blockSize;
+}
+
+void AudioProcessorExt::nonRealtimeStateChanged()
+{
+}
+
+void AudioProcessorExt::processChannelsInParallel (ChannelJob& job, const int numChannels, const int numSamples)
+{
+    if (nonRealtime && renderThreadPool != nullptr && numChannels > 1 && numSamples >= minBlockSizeForThreads)
+    {
+        renderThreadPool->run (job, numChannels);
+    }
+    else
+    {
+        for (int i = 0; i < numChannels; ++i)
+            job.processChunk (i);
+    }
 }
 
 void AudioProcessorExt::setLatencySamples (const int newLatency)
@@ -98,7 +319,20 @@ void AudioProcessorExt::setLatencySamples (const int newLatency)
 void AudioProcessorExt::setParameterNotifyingHost (const int parameterIndex,
                                                 const float newValue)
 {
+    //***
+    PluginParameter* const parameter = (history != nullptr) ? getPluginParameter (parameterIndex) : nullptr;
+    const double oldValue = (parameter != nullptr) ? parameter->getValue() : 0.0;
+
     setParameter (parameterIndex, newValue);
+
+    if (parameter != nullptr)
+    {
+        const ScopedLock sl (historyLock);
+
+        if (history != nullptr)
+            history->valueChanged (parameterIndex, oldValue, parameter->getValue());
+    }
+
     sendParamChangeMessageToListeners (parameterIndex, newValue);
 }
 
@@ -131,6 +365,16 @@ void AudioProcessorExt::beginParameterChangeGesture (int parameterIndex)
     changingParams.setBit (parameterIndex);
    #endif
 
+    //***
+    if (history != nullptr)
+    {
+        PluginParameter* const parameter = getPluginParameter (parameterIndex);
+        const ScopedLock sl (historyLock);
+
+        if (parameter != nullptr && history != nullptr)
+            history->gestureStarted (parameterIndex, parameter->getValue());
+    }
+
     for (int i = listeners.size(); --i >= 0;)
     {
         AudioProcessorListener* l;
@@ -157,6 +401,16 @@ void AudioProcessorExt::endParameterChangeGesture (int parameterIndex)
     changingParams.clearBit (parameterIndex);
    #endif
 
+    //***
+    if (history != nullptr)
+    {
+        PluginParameter* const parameter = getPluginParameter (parameterIndex);
+        const ScopedLock sl (historyLock);
+
+        if (parameter != nullptr && history != nullptr)
+            history->gestureEnded (parameterIndex, parameter->getValue());
+    }
+
     for (int i = listeners.size(); --i >= 0;)
     {
         AudioProcessorListener* l;
@@ -187,6 +441,101 @@ void AudioProcessorExt::updateHostDisplay()
     }
 }
 
+//==============================================================================
+//***
+/** Collects the values for one undo or redo step, so they can be applied
+    after the history lock has been released.
+*/
+class HistoryStepCollector  : public PluginParameterHistory::Target
+{
+public:
+    HistoryStepCollector() {}
+
+    void applyHistoryValue (int parameterIndex, double newValue)
+    {
+        indexes.add (parameterIndex);
+        values.add (newValue);
+    }
+
+    Array<int> indexes;
+    Array<double> values;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (HistoryStepCollector);
+};
+
+void AudioProcessorExt::setUndoHistorySize (const int maxNumChanges)
+{
+    PluginParameterHistory* const newHistory = maxNumChanges > 0 ? new PluginParameterHistory (getNumParameters(), maxNumChanges)
+                                                                 : nullptr;
+    ScopedPointer<PluginParameterHistory> oldHistory;
+
+    {
+        const ScopedLock sl (historyLock);
+        oldHistory = history.release();
+        history = newHistory;
+    }
+}
+
+bool AudioProcessorExt::undoParameterChange()
+{
+    return applyHistoryStep (true);
+}
+
+bool AudioProcessorExt::redoParameterChange()
+{
+    return applyHistoryStep (false);
+}
+
+bool AudioProcessorExt::canUndoParameterChange() const
+{
+    const ScopedLock sl (historyLock);
+    return history != nullptr && history->canUndo();
+}
+
+bool AudioProcessorExt::canRedoParameterChange() const
+{
+    const ScopedLock sl (historyLock);
+    return history != nullptr && history->canRedo();
+}
+
+bool AudioProcessorExt::applyHistoryStep (const bool isUndo)
+{
+    HistoryStepCollector step;
+
+    {
+        const ScopedLock sl (historyLock);
+
+        if (history == nullptr || ! (isUndo ? history->undo (step) : history->redo (step)))
+            return false;
+    }
+
+    {
+        // apply the whole step at once so a block never sees half of it
+        const ScopedLock sl (callbackLock);
+
+        for (int i = 0; i < step.indexes.size(); ++i)
+        {
+            const int parameterIndex = step.indexes.getUnchecked (i);
+            PluginParameter* const parameter = getPluginParameter (parameterIndex);
+
+            if (parameter != nullptr)
+            {
+                parameter->setValue (step.values.getUnchecked (i));
+                parameterValueChanged (parameterIndex);
+            }
+        }
+    }
+
+    for (int i = 0; i < step.indexes.size(); ++i)
+    {
+        const int parameterIndex = step.indexes.getUnchecked (i);
+        sendParamChangeMessageToListeners (parameterIndex, getParameter (parameterIndex));
+    }
+
+    return true;
+}
+
 bool AudioProcessorExt::isParameterAutomatable (int /*parameterIndex*/) const
 {
     return true;
@@ -225,6 +574,10 @@ void AudioProcessorExt::setScaledParameterNotifyingHost (int parameterIndex, flo
     sendParamChangeMessageToListeners (parameterIndex, newValue);
 }
 
+void AudioProcessorExt::parameterValueChanged (int /*parameterIndex*/)
+{
+}
+
 float AudioProcessorExt::getParameterMin (int parameterIndex)
 {
     return 0.0f;
@@ -240,6 +593,104 @@ float AudioProcessorExt::getParameterDefault (int parameterIndex)
     return 1.0f;
 }
 
+PluginParameter* AudioProcessorExt::getPluginParameter (int /*parameterIndex*/)
+{
+    return nullptr;
+}
+
+int AudioProcessorExt::getParameterIndexForIdentifier (const String& identifier) const noexcept
+{
+    return parameterIndex.getIndexForIdentifier (identifier);
+}
+
+void AudioProcessorExt::rebuildParameterIndex()
+{
+    // make sure nothing is still being decoded with the old table
+    finishPendingParameterState();
+
+    const int numParameters = getNumParameters();
+    parameterIndex.reset (numParameters);
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        PluginParameter* const parameter = getPluginParameter (i);
+
+        if (parameter != nullptr)
+            parameterIndex.add (parameter->getIdentifier(), i);
+    }
+}
+
+//==============================================================================
+void AudioProcessorExt::setMaxNumScheduledParameterChanges (const int maxNumChanges)
+{
+    const ScopedLock sl (callbackLock);
+    const SpinLock::ScopedLockType eventLock (parameterEventLock);
+
+    pendingParameterEvents.setCapacity (maxNumChanges);
+    blockParameterEvents.setCapacity (maxNumChanges);
+}
+
+bool AudioProcessorExt::scheduleParameterChange (const int parameterIndex, const float newValue, const int sampleOffset)
+{
+    const SpinLock::ScopedLockType sl (parameterEventLock);
+    return pendingParameterEvents.addChange (parameterIndex, newValue, sampleOffset);
+}
+
+bool AudioProcessorExt::scheduleParameterRamp (const int parameterIndex, const float startValue, const float endValue,
+                                               const int sampleOffset, const int numSamples)
+{
+    const SpinLock::ScopedLockType sl (parameterEventLock);
+    return pendingParameterEvents.addRamp (parameterIndex, startValue, endValue, sampleOffset, numSamples);
+}
+
+int AudioProcessorExt::applyScheduledParameterChanges (const int startSample, const int numSamplesInBlock)
+{
+    if (blockParameterEvents.getCapacity() == 0)
+        return jmax (1, numSamplesInBlock - startSample);
+
+    if (startSample == 0)
+    {
+        // pick up everything the host has sent since the last block
+        const SpinLock::ScopedLockType sl (parameterEventLock);
+        blockParameterEvents.takeEventsFrom (pendingParameterEvents);
+    }
+
+    class ParameterSetter  : public PluginParameterEventList::Target
+    {
+    public:
+        ParameterSetter (AudioProcessorExt& owner_) : owner (owner_) {}
+
+        void setScheduledValue (int parameterIndex, float newValue)
+        {
+            owner.setScaledParameter (parameterIndex, newValue);
+        }
+
+    private:
+        AudioProcessorExt& owner;
+    };
+
+    ParameterSetter setter (*this);
+    return blockParameterEvents.applyChanges (startSample, numSamplesInBlock, setter);
+}
+
+void AudioProcessorExt::getParameterTextUTF8 (int parameterIndex, char* dest, int maxBytes)
+{
+    getParameterText (parameterIndex).copyToUTF8 (dest, (size_t) maxBytes);
+}
+
+bool AudioProcessorExt::setParameterFromText (int parameterIndex, const char* text)
+{
+    PluginParameter* const parameter = getPluginParameter (parameterIndex);
+    double normalisedValue;
+
+    if (parameter == nullptr || ! parameter->getNormalisedValueFromText (text, normalisedValue))
+        return false;
+
+    // go through setParameter() so the processor sees the change like any other
+    setParameterNotifyingHost (parameterIndex, (float) normalisedValue);
+    return true;
+}
+
 //==============================================================================
 void AudioProcessorExt::editorBeingDeleted (AudioProcessorEditor* const editor) noexcept
 {
@@ -316,6 +767,142 @@ XmlElement* AudioProcessorExt::getXmlFromBinary (const void* data,
     return nullptr;
 }
 
+//***
+void AudioProcessorExt::copyParametersToBinary (const OwnedArray<PluginParameter>& parameters,
+                                                juce::MemoryBlock& destData,
+                                                const bool shouldCompress)
+{
+    PluginParameterState::write (parameters, destData, shouldCompress);
+}
+
+bool AudioProcessorExt::setParametersFromBinary (OwnedArray<PluginParameter>& parameters,
+                                                 const void* data, const int sizeInBytes)
+{
+    if (PluginParameterState::read (data, sizeInBytes, parameters))
+        return true;
+
+    // fall back to state saved by older versions as XML
+    ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
+
+    if (xmlState == nullptr)
+        return false;
+
+    for (int i = 0; i < parameters.size(); ++i)
+        parameters.getUnchecked (i)->readXml (xmlState);
+
+    return true;
+}
+
+void AudioProcessorExt::setParametersFromBinaryAsync (const void* data, const int sizeInBytes)
+{
+    if (stateRestorer == nullptr)
+    {
+        StateRestorer* const newRestorer = new StateRestorer();
+
+        const ScopedLock sl (callbackLock);
+        stateRestorer = newRestorer;
+    }
+
+    if (parameterIndex.getNumParameters() == 0)
+        rebuildParameterIndex();
+
+    if (PluginParameterState::isBinaryState (data, sizeInBytes))
+    {
+        stateRestorer->decodeAsync (data, sizeInBytes, getNumParameters(), parameterIndex);
+
+        if (! isProcessingAudio())
+            finishPendingParameterState();
+    }
+    else
+    {
+        // XML state is decoded here where it's safe to look at the parameters,
+        // but still applied all in one go
+        ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
+
+        if (xmlState != nullptr)
+        {
+            PluginParameterFrame xmlFrame (getNumParameters());
+
+            for (int i = 0; i < xmlState->getNumAttributes(); ++i)
+            {
+                const String attributeName (xmlState->getAttributeName (i));
+                int index = parameterIndex.getIndexForIdentifier (attributeName);
+
+                // older state used the names, which may not be the identifiers
+                if (index < 0)
+                {
+                    for (int j = 0; j < xmlFrame.getNumParameters(); ++j)
+                    {
+                        PluginParameter* const parameter = getPluginParameter (j);
+
+                        if (parameter != nullptr && parameter->getName() == attributeName)
+                        {
+                            index = j;
+                            break;
+                        }
+                    }
+                }
+
+                if (isPositiveAndBelow (index, xmlFrame.getNumParameters()))
+                    xmlFrame.setValue (index, xmlState->getAttributeValue (i).getDoubleValue());
+            }
+
+            finishPendingParameterState();
+
+            const ScopedLock sl (callbackLock);
+            applyParameterFrame (xmlFrame);
+        }
+    }
+}
+
+void AudioProcessorExt::applyPendingParameterState()
+{
+    lastBlockTime = jmax ((uint32) 1, Time::getMillisecondCounter());
+
+    if (stateRestorer != nullptr)
+        stateRestorer->applyIfReady (*this);
+}
+
+void AudioProcessorExt::finishPendingParameterState()
+{
+    if (stateRestorer != nullptr)
+    {
+        const ScopedLock sl (callbackLock);
+
+        stateRestorer->decodeNow();
+        stateRestorer->applyIfReady (*this);
+    }
+}
+
+bool AudioProcessorExt::isProcessingAudio() const noexcept
+{
+    const uint32 lastTime = lastBlockTime.get();
+
+    return lastTime != 0
+            && ! suspended
+            && Time::getMillisecondCounter() - lastTime < 250;
+}
+
+void AudioProcessorExt::applyParameterFrame (const PluginParameterFrame& frame)
+{
+    const int numToApply = jmin (frame.getNumParameters(), getNumParameters());
+
+    for (int i = 0; i < numToApply; ++i)
+    {
+        PluginParameter* const parameter = frame.hasValue (i) ? getPluginParameter (i) : nullptr;
+
+        if (parameter != nullptr)
+        {
+            parameter->setValue (frame.getValue (i));
+
+            if (! (smoothsGainsOnRestore && isGainUnit (parameter->getUnit())))
+                parameter->resetSmoothing();
+
+            parameterValueChanged (i);
+        }
+    }
+}
+
 //==============================================================================
 //void AudioProcessorListener::audioProcessorParameterChangeGestureBegin (AudioProcessor*, int) {}
 //void AudioProcessorListener::audioProcessorParameterChangeGestureEnd (AudioProcessor*, int) {}
@@ -30,6 +30,10 @@
 //#include "juce_AudioProcessorExtListener.h"
 //#include "juce_AudioPlayHead.h"
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "juce_RenderThreadPool.h"
+#include "juce_PluginParameterState.h"
+#include "juce_PluginParameterHistory.h"
+#include "juce_PluginParameterEventList.h"
 
 
 //==============================================================================
@@ -45,6 +49,8 @@
     Derive your filter class from this base class, and if you're building a plugin,
     you should implement a global function called createPluginFilter() which creates
     and returns a new instance of your subclass.
+    The wrappers in Source declare it as returning an AudioProcessorExt*, rather
+    than the AudioProcessor* that JUCE's own wrappers use, so define it that way.
 */
 class JUCE_API  AudioProcessorExt : public AudioProcessor
 {
@@ -116,6 +122,60 @@ public:
 
     void setNonRealtime (bool isNonRealtime) noexcept;
 
+    //***
+    /** Sets up how the processor should behave while the host is rendering offline.
+
+        When isNonRealtime() is true the host isn't waiting on the audio thread, so
+        it's safe to trade time for quality. The offline block size is the size your
+        processor should use for its internal buffers when rendering offline (it
+        will never be smaller than the host's block size), and maxNumThreads is the
+        most threads processChannelsInParallel() will use, including the caller.
+        Blocks shorter than minBlockSizeForThreads are always processed on the
+        calling thread, as waking the helpers would cost more than it saves.
+
+        The helper threads are started here rather than when the host switches to
+        offline rendering, as that can happen on the audio thread, so call this
+        from your constructor or prepareToPlay(). They sleep until they're needed.
+
+        By default the internal block size is the same as the host's and only one
+        thread is used.
+
+        @see getInternalBlockSize, processChannelsInParallel
+    */
+    void setOfflineRenderOptions (int offlineBlockSize, int maxNumThreads,
+                                  int minBlockSizeForThreads = 512);
+
+    /** Returns the block size to use for internal buffers.
+        This is the host's block size when running in real-time, and the offline
+        block size set with setOfflineRenderOptions() when rendering offline.
+    */
+    int getInternalBlockSize() const noexcept;
+
+    /** Returns true if processing should use its most accurate algorithms.
+        This is currently the same as isNonRealtime() but gives processors a
+        single place to decide which kernels to use.
+    */
+    bool isHighQualityRender() const noexcept                           { return nonRealtime; }
+
+    /** Called when the host switches between real-time and offline rendering.
+        This may be called on the audio thread so don't do anything slow here, just
+        set a flag and pick up the change in your next prepareToPlay() or processBlock().
+    */
+    virtual void nonRealtimeStateChanged();
+
+    /** A job that processes one channel of a block. */
+    typedef RenderThreadPool::Job ChannelJob;
+
+    /** Calls job.processChunk() for each channel from 0 to numChannels - 1.
+
+        In real-time this just loops over the channels on the calling thread. When
+        rendering offline, and numSamples is at least the threshold given to
+        setOfflineRenderOptions(), the channels will be spread over the threads it
+        set up. Each channel must only touch its own data and state so the results
+        are the same whichever thread processes it.
+    */
+    void processChannelsInParallel (ChannelJob& job, int numChannels, int numSamples);
+
     //==============================================================================
     virtual AudioProcessorEditor* createEditor() = 0;
 
@@ -135,6 +195,24 @@ public:
 
     virtual const String getParameterText (int parameterIndex) = 0;
 
+    //***
+    /** Copies a parameter's display text into a buffer of maxBytes, including the
+        terminator. Plugin wrappers use this instead of getParameterText() so you
+        can return cached text without creating a String every time the host polls.
+
+        By default this copies the result of getParameterText().
+    */
+    virtual void getParameterTextUTF8 (int parameterIndex, char* dest, int maxBytes);
+
+    /** Sets a parameter from some text the user has typed into the host.
+
+        By default this parses the text with the parameter returned by
+        getPluginParameter() and applies it, limited to the parameter's range,
+        with setParameterNotifyingHost(). It returns false if there isn't a
+        parameter or the text couldn't be read.
+    */
+    virtual bool setParameterFromText (int parameterIndex, const char* text);
+
     virtual void setParameter (int parameterIndex,
                                float newValue) = 0;
 
@@ -151,6 +229,33 @@ public:
 
     void updateHostDisplay();
 
+    //==============================================================================
+    //***
+    /** Turns on undo and redo for parameter changes.
+
+        Changes made between beginParameterChangeGesture() and
+        endParameterChangeGesture() are recorded as one step, as are single
+        calls to setParameterNotifyingHost() made outside a gesture. Changes
+        the host makes by calling setParameter() aren't recorded.
+
+        The history keeps up to maxNumChanges parameter changes in memory that's
+        allocated here, dropping the oldest steps once it's full. Passing 0
+        turns the history off. This uses getPluginParameter(), so you must
+        override that to use it.
+    */
+    void setUndoHistorySize (int maxNumChanges);
+
+    /** Undoes the last step, applying all its changes together and notifying
+        the host. Returns false if there was nothing to undo.
+    */
+    bool undoParameterChange();
+
+    /** Redoes the last undone step. Returns false if there was nothing to redo. */
+    bool redoParameterChange();
+
+    bool canUndoParameterChange() const;
+    bool canRedoParameterChange() const;
+
     //==============================================================================
     //***
     /** Some hosts may call this if they support parameter ranges outside of the
@@ -172,6 +277,17 @@ public:
      setParameterNotifyingHost().
      */
     void setScaledParameterNotifyingHost (int parameterIndex, float newValue);
+
+    /** Called after a parameter's value has been changed, however it was changed.
+
+        Override this to keep anything that depends on the parameters up to date,
+        e.g. group change flags or linked parameters. The processor calls it
+        after restoring state, applying a state frame, and undoing or redoing.
+        Your own setParameter() and setScaledParameter() should call it, as should
+        any code that writes to your parameters directly, such as preset recall or
+        morphing. This can be called on the audio thread. By default it does nothing.
+     */
+    virtual void parameterValueChanged (int parameterIndex);
     
     /** Some hosts may call this if they support parameter ranges outside of the
      0 - 1.0 range. This should return the minimum value your parameter can have.
@@ -188,6 +304,50 @@ public:
      */
     virtual float getParameterDefault (int parameterIndex);
     
+    /** If your parameters are PluginParameter objects this should return the
+        one at a given index. This is used to restore state directly into the
+        parameters, and by default returns nullptr.
+     */
+    virtual PluginParameter* getPluginParameter (int parameterIndex);
+
+    /** Returns the index of the parameter with a given identifier, or -1.
+        @see PluginParameter::setIdentifier, rebuildParameterIndex
+    */
+    int getParameterIndexForIdentifier (const String& identifier) const noexcept;
+
+    //==============================================================================
+    //***
+    /** Turns on sample-accurate parameter changes for hosts that can send them.
+
+        When a host says which sample of the next block a change belongs to, or
+        asks for a parameter to ramp, the change is queued up rather than being
+        applied straight away. Your processBlock() must then call
+        applyScheduledParameterChanges() to split each block at the changes.
+
+        Up to maxNumChanges changes can be waiting at once, using memory that's
+        allocated here. Passing 0 (the default) turns this off, so every change
+        is applied as soon as the host makes it. Call this from your constructor.
+    */
+    void setMaxNumScheduledParameterChanges (int maxNumChanges);
+
+    /** Returns true if setMaxNumScheduledParameterChanges() has turned scheduling on. */
+    bool canScheduleParameterChanges() const noexcept                   { return pendingParameterEvents.getCapacity() > 0; }
+
+    /** Queues a full-scale parameter change for a sample of the next block.
+
+        The plugin wrappers call this. It can be called from any thread and won't
+        allocate, but returns false if scheduling is off or the queue is full, in
+        which case the caller should just use setScaledParameter().
+    */
+    bool scheduleParameterChange (int parameterIndex, float newValue, int sampleOffset);
+
+    /** Queues a full-scale parameter ramp, which starts at a sample of the next
+        block (or before it if the offset is negative) and lasts numSamples.
+        @see scheduleParameterChange
+    */
+    bool scheduleParameterRamp (int parameterIndex, float startValue, float endValue,
+                                int sampleOffset, int numSamples);
+
     //==============================================================================
     virtual int getNumPrograms() = 0;
 
@@ -231,6 +391,83 @@ protected:
 
     static XmlElement* getXmlFromBinary (const void* data, int sizeInBytes);
 
+    //***
+    /** Writes the values of some parameters to a block of memory using the
+        binary format described in PluginParameterState.
+
+        This is much quicker than copyXmlToBinary() for large parameter sets. If
+        shouldCompress is true the values are compressed, which is only worth
+        doing when there are thousands of them and many are the same; the data
+        can be read back either way.
+    */
+    static void copyParametersToBinary (const OwnedArray<PluginParameter>& parameters,
+                                        juce::MemoryBlock& destData,
+                                        bool shouldCompress = false);
+
+    /** Restores some parameters from data created by copyParametersToBinary().
+
+        Older state that was saved with copyXmlToBinary() is also recognised and
+        read with PluginParameter::readXml(). Returns false if the data wasn't
+        in either format. As this is static it can't call parameterValueChanged(),
+        so do that yourself afterwards, or use setParametersFromBinaryAsync().
+    */
+    static bool setParametersFromBinary (OwnedArray<PluginParameter>& parameters,
+                                         const void* data, int sizeInBytes);
+
+    /** Restores parameter state without disturbing the audio thread.
+
+        If audio is running, binary state is decoded on a shared background thread
+        into a PluginParameterFrame, and the whole frame is applied the next time
+        applyPendingParameterState() is called at the start of a block. If audio
+        isn't running the state is applied straight away. Old XML state is decoded
+        on the calling thread but still applied in the same way.
+
+        This uses getPluginParameter(), so you must override that to use it.
+    */
+    void setParametersFromBinaryAsync (const void* data, int sizeInBytes);
+
+    /** Call this at the start of your processBlock() to pick up any state that
+        has been restored with setParametersFromBinaryAsync(). This won't block
+        or allocate.
+    */
+    void applyPendingParameterState();
+
+    /** Decodes and applies any state that's still waiting, on the calling thread.
+        Call this before saving your state so it reflects the last restore.
+    */
+    void finishPendingParameterState();
+
+    /** If this is true (the default), restored gain-like parameters glide to their
+        new values using their normal smoothing, rather than jumping.
+        @see isGainUnit
+    */
+    void setSmoothsGainsOnRestore (bool shouldSmoothGains) noexcept     { smoothsGainsOnRestore = shouldSmoothGains; }
+
+    /** Rebuilds the table used to look up parameters by their identifiers when
+        state is restored. This uses getPluginParameter(), and is done the first
+        time it's needed, but call it again if you change any identifiers.
+    */
+    void rebuildParameterIndex();
+
+    /** Applies the scheduled parameter changes that are due at a sample of the
+        current block, and returns the number of samples you can process before
+        the next one. Use it in a loop like this at the start of processBlock():
+
+        @code
+        for (int pos = 0; pos < numSamples;)
+        {
+            const int num = applyScheduledParameterChanges (pos, numSamples);
+            // ..process num samples, starting at pos..
+            pos += num;
+        }
+        @endcode
+
+        Changes are made with setScaledParameter(). If scheduling is turned off
+        this just returns the rest of the block. It won't allocate.
+        @see setMaxNumScheduledParameterChanges
+    */
+    int applyScheduledParameterChanges (int startSample, int numSamplesInBlock);
+
     AudioPlayHead* playHead;
 
     void sendParamChangeMessageToListeners (int parameterIndex, float newValue);
@@ -241,8 +478,28 @@ private:
     double sampleRate;
     int blockSize, numInputChannels, numOutputChannels, latencySamples;
     bool suspended, nonRealtime;
+    int offlineBlockSize, maxNumRenderThreads, minBlockSizeForThreads;
+    ScopedPointer<RenderThreadPool> renderThreadPool;
     CriticalSection callbackLock, listenerLock;
 
+    PluginParameterIndex parameterIndex;
+
+    class StateRestorer;
+    friend class StateRestorer;
+    ScopedPointer<StateRestorer> stateRestorer;
+    Atomic<uint32> lastBlockTime;
+    bool smoothsGainsOnRestore;
+
+    ScopedPointer<PluginParameterHistory> history;
+    CriticalSection historyLock;
+
+    PluginParameterEventList pendingParameterEvents, blockParameterEvents;
+    SpinLock parameterEventLock;
+
+    bool isProcessingAudio() const noexcept;
+    bool applyHistoryStep (bool isUndo);
+    void applyParameterFrame (const PluginParameterFrame& frame);
+
    #if JUCE_DEBUG
     BigInteger changingParams;
    #endif
@@ -0,0 +1,147 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_MidiEventFifo.h"
+
+MidiEventFifo::MidiEventFifo (const int maxNumEvents, const int sysexBufferSize)
+    : eventFifo (jmax (2, maxNumEvents + 1)),     // an AbstractFifo can only hold one less than its size
+      sysexFifo (jmax (2, sysexBufferSize + 1)),
+      numDropped (0)
+{
+    events.malloc ((size_t) eventFifo.getTotalSize());
+    sysexData.malloc ((size_t) sysexFifo.getTotalSize());
+    sysexScratch.malloc ((size_t) sysexFifo.getTotalSize());
+}
+
+MidiEventFifo::~MidiEventFifo()
+{
+}
+
+//==============================================================================
+bool MidiEventFifo::push (const void* const data, const int numBytes, const int samplePosition) noexcept
+{
+    if (numBytes <= 0)
+        return true;
+
+    if (eventFifo.getFreeSpace() < 1
+         || (numBytes > (int) maxInlineBytes && sysexFifo.getFreeSpace() < numBytes))
+    {
+        ++numDropped;
+        return false;
+    }
+
+    int start1, size1, start2, size2;
+
+    // long messages go in the sysex ring first, so they're there by the time
+    // the event that refers to them can be read
+    if (numBytes > (int) maxInlineBytes)
+    {
+        sysexFifo.prepareToWrite (numBytes, start1, size1, start2, size2);
+        memcpy (sysexData + start1, data, (size_t) size1);
+
+        if (size2 > 0)
+            memcpy (sysexData + start2, static_cast<const uint8*> (data) + size1, (size_t) size2);
+
+        sysexFifo.finishedWrite (size1 + size2);
+    }
+
+    eventFifo.prepareToWrite (1, start1, size1, start2, size2);
+    jassert (size1 == 1);
+
+    Event& e = events [start1];
+    e.samplePosition = samplePosition;
+    e.numBytes = numBytes;
+
+    if (numBytes <= (int) maxInlineBytes)
+        memcpy (e.data, data, (size_t) numBytes);
+
+    eventFifo.finishedWrite (1);
+    return true;
+}
+
+void MidiEventFifo::popAll (MidiBuffer& dest, const int numSamples)
+{
+    int start1, size1, start2, size2;
+    eventFifo.prepareToRead (eventFifo.getNumReady(), start1, size1, start2, size2);
+
+    const int lastSample = jmax (0, numSamples - 1);
+
+    for (int i = 0; i < size1; ++i)
+        popEvent (events [start1 + i], dest, lastSample);
+
+    for (int i = 0; i < size2; ++i)
+        popEvent (events [start2 + i], dest, lastSample);
+
+    eventFifo.finishedRead (size1 + size2);
+}
+
+void MidiEventFifo::popEvent (const Event& e, MidiBuffer& dest, const int lastSample)
+{
+    const int position = jlimit (0, lastSample, e.samplePosition);
+
+    if (e.numBytes <= (int) maxInlineBytes)
+    {
+        dest.addEvent (e.data, e.numBytes, position);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    sysexFifo.prepareToRead (e.numBytes, start1, size1, start2, size2);
+    jassert (size1 + size2 == e.numBytes);
+
+    if (size2 == 0)
+    {
+        dest.addEvent (sysexData + start1, size1, position);
+    }
+    else
+    {
+        // the message wraps around the end of the ring, so join it up first
+        memcpy (sysexScratch, sysexData + start1, (size_t) size1);
+        memcpy (sysexScratch + size1, sysexData + start2, (size_t) size2);
+        dest.addEvent (sysexScratch, size1 + size2, position);
+    }
+
+    sysexFifo.finishedRead (size1 + size2);
+}
+
+int MidiEventFifo::getMaxBufferSizeNeeded() const noexcept
+{
+    // a MidiBuffer stores each event as a timestamp and a length followed by
+    // the data, so allow a generous header for every event, plus the whole
+    // sysex ring for the long messages' data
+    const int headerBytes = (int) (sizeof (int) + sizeof (int));
+
+    return (eventFifo.getTotalSize() - 1) * (headerBytes + (int) maxInlineBytes)
+             + (sysexFifo.getTotalSize() - 1);
+}
+
+void MidiEventFifo::clear() noexcept
+{
+    eventFifo.reset();
+    sysexFifo.reset();
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,109 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_MIDIEVENTFIFO_JUCEHEADER__
+#define __JUCE_MIDIEVENTFIFO_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    Passes MIDI events from one thread to another without locking.
+
+    Plugin wrappers use this when the host delivers MIDI on a different thread
+    to the one that renders audio. The host's thread push()es each event with
+    its sample offset, and the audio thread pops them all into its MidiBuffer
+    at the start of the next block, so a burst of MIDI can never hold up the
+    audio thread.
+
+    Short messages are stored in a preallocated ring of fixed-size events.
+    Longer ones, i.e. sysex, are copied into a separate ring of bytes with a
+    fixed size, so the memory used is bounded. If either ring is full the event
+    is dropped and counted, rather than blocking or allocating.
+
+    This is a single-producer, single-consumer queue: only one thread may push
+    and only one thread may pop at any one time.
+ */
+class MidiEventFifo
+{
+public:
+    //==============================================================================
+    /** Creates a FIFO with room for a number of events and sysex bytes. */
+    MidiEventFifo (int maxNumEvents = 1024, int sysexBufferSize = 16384);
+
+    /** Destructor. */
+    ~MidiEventFifo();
+
+    //==============================================================================
+    /** Adds an event, returning false if there wasn't room for it.
+        This doesn't lock or allocate.
+     */
+    bool push (const void* data, int numBytes, int samplePosition) noexcept;
+
+    /** Moves all the waiting events into a MidiBuffer, with their sample
+        positions limited to a block of numSamples. This doesn't lock, and won't
+        allocate as long as the buffer has been given enough space up-front with
+        MidiBuffer::ensureSize().
+     */
+    void popAll (MidiBuffer& dest, int numSamples);
+
+    /** Throws away all the waiting events.
+        This isn't thread-safe, so only call it when nothing is pushing or popping.
+     */
+    void clear() noexcept;
+
+    /** Returns the number of events waiting. */
+    int getNumReady() const noexcept                        { return eventFifo.getNumReady(); }
+
+    /** Returns the number of events that have been dropped because the FIFO was full. */
+    int getNumDropped() const noexcept                      { return numDropped.get(); }
+
+    /** Returns the number of bytes a MidiBuffer needs to hold everything that
+        popAll() could write into it when the FIFO is full.
+        Pass this to MidiBuffer::ensureSize() so that popAll() never allocates.
+     */
+    int getMaxBufferSizeNeeded() const noexcept;
+
+private:
+    //==============================================================================
+    enum { maxInlineBytes = 8 };
+
+    struct Event
+    {
+        int samplePosition, numBytes;
+        uint8 data [maxInlineBytes];
+    };
+
+    AbstractFifo eventFifo, sysexFifo;
+    HeapBlock<Event> events;
+    HeapBlock<uint8> sysexData, sysexScratch;
+    Atomic<int> numDropped;
+
+    void popEvent (const Event& e, MidiBuffer& dest, int lastSample);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiEventFifo);
+};
+
+#endif //__JUCE_MIDIEVENTFIFO_JUCEHEADER__
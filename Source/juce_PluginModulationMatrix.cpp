@@ -0,0 +1,251 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginModulationMatrix.h"
+
+PluginModulationMatrix::PluginModulationMatrix()
+    : numParameters (0),
+      numSources (0),
+      maxNumRoutes (0),
+      maxBlockSize (0),
+      numRoutes (0),
+      numDestinations (0)
+{
+}
+
+PluginModulationMatrix::~PluginModulationMatrix()
+{
+}
+
+//==============================================================================
+void PluginModulationMatrix::prepare (const OwnedArray<PluginParameter>& parameters,
+                                      const int numSources_, const int maxNumRoutes_, const int maxBlockSize_)
+{
+    numParameters = parameters.size();
+    numSources = jmax (0, numSources_);
+    maxNumRoutes = jmax (0, maxNumRoutes_);
+    maxBlockSize = jmax (0, maxBlockSize_);
+
+    // each route can add at most one more parameter to modulate
+    const int maxNumDestinations = jmin (maxNumRoutes, numParameters);
+
+    mins.malloc ((size_t) jmax (1, numParameters));
+    maxs.malloc ((size_t) jmax (1, numParameters));
+    destinationForParameter.malloc ((size_t) jmax (1, numParameters));
+    parameterForDestination.malloc ((size_t) jmax (1, maxNumDestinations));
+    routes.malloc ((size_t) jmax (1, maxNumRoutes));
+    sourceBuffers.calloc ((size_t) jmax (1, numSources * maxBlockSize));
+    destinationBuffers.malloc ((size_t) jmax (1, maxNumDestinations * maxBlockSize));
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        PluginParameter* const parameter = parameters.getUnchecked (i);
+
+        mins[i] = (float) parameter->getMin();
+        maxs[i] = (float) parameter->getMax();
+        destinationForParameter[i] = -1;
+    }
+
+    numRoutes = 0;
+    numDestinations = 0;
+}
+
+//==============================================================================
+bool PluginModulationMatrix::setRoute (const int sourceIndex, const int parameterIndex, const float depth) noexcept
+{
+    if (! (isPositiveAndBelow (sourceIndex, numSources) && isPositiveAndBelow (parameterIndex, numParameters)))
+        return false;
+
+    const int existing = findRoute (sourceIndex, parameterIndex);
+
+    if (depth == 0.0f)
+    {
+        if (existing >= 0)
+            removeRoute (existing);
+
+        return true;
+    }
+
+    const float scaledDepth = depth * (maxs[parameterIndex] - mins[parameterIndex]);
+
+    if (existing >= 0)
+    {
+        routes[existing].depth = depth;
+        routes[existing].scaledDepth = scaledDepth;
+        return true;
+    }
+
+    if (numRoutes >= maxNumRoutes)
+        return false;
+
+    int destination = destinationForParameter [parameterIndex];
+
+    if (destination < 0)
+    {
+        destination = numDestinations++;
+        destinationForParameter [parameterIndex] = destination;
+        parameterForDestination [destination] = parameterIndex;
+    }
+
+    Route& r = routes [numRoutes++];
+    r.source = sourceIndex;
+    r.destination = destination;
+    r.depth = depth;
+    r.scaledDepth = scaledDepth;
+
+    sortRoutes();
+    return true;
+}
+
+float PluginModulationMatrix::getRouteDepth (const int sourceIndex, const int parameterIndex) const noexcept
+{
+    const int index = findRoute (sourceIndex, parameterIndex);
+
+    return index >= 0 ? routes[index].depth : 0.0f;
+}
+
+void PluginModulationMatrix::clearRoutes() noexcept
+{
+    for (int i = 0; i < numDestinations; ++i)
+        destinationForParameter [parameterForDestination[i]] = -1;
+
+    numRoutes = 0;
+    numDestinations = 0;
+}
+
+int PluginModulationMatrix::findRoute (const int sourceIndex, const int parameterIndex) const noexcept
+{
+    const int destination = isPositiveAndBelow (parameterIndex, numParameters) ? destinationForParameter [parameterIndex] : -1;
+
+    if (destination >= 0)
+        for (int i = 0; i < numRoutes; ++i)
+            if (routes[i].destination == destination && routes[i].source == sourceIndex)
+                return i;
+
+    return -1;
+}
+
+void PluginModulationMatrix::removeRoute (const int routeIndex) noexcept
+{
+    const int destination = routes [routeIndex].destination;
+
+    for (int i = routeIndex + 1; i < numRoutes; ++i)
+        routes[i - 1] = routes[i];
+
+    --numRoutes;
+
+    for (int i = 0; i < numRoutes; ++i)
+        if (routes[i].destination == destination)
+            return;
+
+    // that was the last route to this parameter, so move the last destination
+    // into its place to keep the buffers packed
+    const int lastDestination = --numDestinations;
+    destinationForParameter [parameterForDestination [destination]] = -1;
+
+    if (destination != lastDestination)
+    {
+        const int movedParameter = parameterForDestination [lastDestination];
+        parameterForDestination [destination] = movedParameter;
+        destinationForParameter [movedParameter] = destination;
+
+        for (int i = 0; i < numRoutes; ++i)
+            if (routes[i].destination == lastDestination)
+                routes[i].destination = destination;
+
+        sortRoutes();
+    }
+}
+
+void PluginModulationMatrix::sortRoutes() noexcept
+{
+    // there are only ever a few routes, so a simple insertion sort is fine
+    for (int i = 1; i < numRoutes; ++i)
+    {
+        const Route r (routes[i]);
+        int j = i;
+
+        while (j > 0 && routes[j - 1].destination > r.destination)
+        {
+            routes[j] = routes[j - 1];
+            --j;
+        }
+
+        routes[j] = r;
+    }
+}
+
+//==============================================================================
+float* PluginModulationMatrix::getSourceBuffer (const int sourceIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (sourceIndex, numSources));
+    return sourceBuffers + sourceIndex * maxBlockSize;
+}
+
+void PluginModulationMatrix::process (const OwnedArray<PluginParameter>& parameters, int numSamples) noexcept
+{
+    // make sure prepare() was called with a big enough block size
+    jassert (numSamples <= maxBlockSize);
+    numSamples = jmin (numSamples, maxBlockSize);
+
+    const Route* r = routes;
+    const Route* const routesEnd = routes + numRoutes;
+
+    for (int d = 0; d < numDestinations; ++d)
+    {
+        const int parameterIndex = parameterForDestination[d];
+        float* const dest = destinationBuffers + d * maxBlockSize;
+        const float base = (float) parameters.getUnchecked (parameterIndex)->getValue();
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = base;
+
+        for (; r != routesEnd && r->destination == d; ++r)
+        {
+            const float* const src = sourceBuffers + r->source * maxBlockSize;
+            const float depth = r->scaledDepth;
+
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] += src[i] * depth;
+        }
+
+        const float low = mins [parameterIndex];
+        const float high = maxs [parameterIndex];
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = jlimit (low, high, dest[i]);
+    }
+}
+
+const float* PluginModulationMatrix::getModulatedValues (const int parameterIndex) const noexcept
+{
+    const int destination = isPositiveAndBelow (parameterIndex, numParameters) ? destinationForParameter [parameterIndex] : -1;
+
+    return destination >= 0 ? destinationBuffers + destination * maxBlockSize
+                            : nullptr;
+}
+
+//END_JUCE_NAMESPACE
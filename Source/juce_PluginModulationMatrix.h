@@ -0,0 +1,141 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINMODULATIONMATRIX_JUCEHEADER__
+#define __JUCE_PLUGINMODULATIONMATRIX_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameter.h"
+
+//==============================================================================
+/**
+    Routes internal modulation sources, such as LFOs, envelopes and macros, to
+    parameters without changing the parameters themselves.
+
+    Each parameter keeps its base value, which is what the host automates and
+    what gets saved. Every block you fill each source's buffer with its output,
+    then call process(), which works out a buffer of modulated values for each
+    parameter that has a route to it:
+
+    @code
+    modulated = jlimit (min, max, base + sum (source * depth * (max - min)))
+    @endcode
+
+    Only parameters with routes get a buffer, and the routes are kept sorted by
+    the parameter they go to, so process() is a fill, a run of multiply-adds
+    and a clip for each of those buffers. These are simple loops over
+    contiguous floats which the compiler can vectorise.
+
+    All the memory is allocated by prepare(), so setRoute() and process() can
+    be called on the audio thread. Routes mustn't be changed while process() is
+    running on another thread though, so if you change them from the message
+    thread hold the processor's callback lock.
+
+    @code
+    // in prepareToPlay()
+    matrix.prepare (parameters, numLfos, 32, samplesPerBlock);
+    matrix.setRoute (lfo1, cutoffParam, 0.25f);
+
+    // in processBlock()
+    lfo1.render (matrix.getSourceBuffer (0), numSamples);
+    matrix.process (parameters, numSamples);
+
+    const float* cutoff = matrix.getModulatedValues (cutoffParam);
+    @endcode
+ */
+class PluginModulationMatrix
+{
+public:
+    //==============================================================================
+    /** Creates an empty matrix. Call prepare() before using it. */
+    PluginModulationMatrix();
+
+    /** Destructor. */
+    ~PluginModulationMatrix();
+
+    //==============================================================================
+    /** Reads the ranges of some parameters and allocates room for a number of
+        sources and routes, and blocks of up to maxBlockSize samples. This
+        removes any existing routes.
+     */
+    void prepare (const OwnedArray<PluginParameter>& parameters,
+                  int numSources, int maxNumRoutes, int maxBlockSize);
+
+    int getNumSources() const noexcept                      { return numSources; }
+    int getNumRoutes() const noexcept                       { return numRoutes; }
+
+    //==============================================================================
+    /** Sets how much a source modulates a parameter.
+
+        The depth is a proportion of the parameter's range, so with a source going
+        from -1 to 1 a depth of 0.5 sweeps the whole range. A depth of 0 removes the
+        route. Returns false if there's no room for a new route.
+     */
+    bool setRoute (int sourceIndex, int parameterIndex, float depth) noexcept;
+
+    /** Returns the depth of a route, or 0 if there isn't one. */
+    float getRouteDepth (int sourceIndex, int parameterIndex) const noexcept;
+
+    /** Removes all the routes. */
+    void clearRoutes() noexcept;
+
+    //==============================================================================
+    /** Returns the buffer to write a source's output into before calling process(). */
+    float* getSourceBuffer (int sourceIndex) const noexcept;
+
+    /** Works out the modulated values for the first numSamples of the block. */
+    void process (const OwnedArray<PluginParameter>& parameters, int numSamples) noexcept;
+
+    /** Returns a parameter's modulated values for the last block, or nullptr if
+        nothing is routed to it, in which case just use its normal value.
+     */
+    const float* getModulatedValues (int parameterIndex) const noexcept;
+
+    /** Returns true if anything is routed to a parameter. */
+    bool isModulated (int parameterIndex) const noexcept    { return getModulatedValues (parameterIndex) != nullptr; }
+
+private:
+    //==============================================================================
+    struct Route
+    {
+        int source, destination;
+        float depth, scaledDepth;
+    };
+
+    int numParameters, numSources, maxNumRoutes, maxBlockSize;
+    int numRoutes, numDestinations;
+    HeapBlock<float> mins, maxs, sourceBuffers, destinationBuffers;
+    HeapBlock<int> destinationForParameter, parameterForDestination;
+    HeapBlock<Route> routes;
+
+    int findRoute (int sourceIndex, int parameterIndex) const noexcept;
+    void removeRoute (int routeIndex) noexcept;
+    void sortRoutes() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginModulationMatrix);
+};
+
+#endif //__JUCE_PLUGINMODULATIONMATRIX_JUCEHEADER__
@@ -8,6 +8,7 @@
 
 //BEGIN_JUCE_NAMESPACE
 #include "juce_PluginParameter.h"
+#include "juce_PluginParameterIndex.h"
 
 PluginParameter::PluginParameter()
 {
@@ -25,77 +26,215 @@ PluginParameter::PluginParameter()
 }
 
 PluginParameter::PluginParameter (const PluginParameter& other)
+    : valueBits (other.valueBits.get()),
+      valueObject (bitsToDouble (other.valueBits.get())),
+      descriptor (PluginParameterDescriptor::getShared (*other.descriptor)),
+      smoothValue (other.smoothValue)
 {
-	name = other.name;
-    description = other.description;
-    unitSuffix = other.unitSuffix;
-    min = other.min;
-    max = other.max;
-    defaultValue = other.defaultValue;
-	smoothCoeff = other.smoothCoeff;
-    smoothValue = other.smoothValue;
-	skewFactor = other.skewFactor;
-    step = other.step;
-	unit = other.unit;
-    setValue (double (other.valueObject.getValue()));
+}
+
+PluginParameter& PluginParameter::operator= (const PluginParameter& other)
+{
+	if (descriptor != other.descriptor)
+	{
+		PluginParameterDescriptor::releaseShared (descriptor);
+		descriptor = PluginParameterDescriptor::getShared (*other.descriptor);
+		textCache.invalidate();
+	}
+	
+	setValueInternal (bitsToDouble (other.valueBits.get()));
+	smoothValue = other.smoothValue;
+	
+	return *this;
+}
+
+#if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+PluginParameter::PluginParameter (PluginParameter&& other) noexcept
+    : valueBits (other.valueBits.get()),
+      valueObject (bitsToDouble (other.valueBits.get())),
+      descriptor (PluginParameterDescriptor::getDefault()),
+      smoothValue (other.smoothValue)
+{
+	// swapping the pointers doesn't touch the pool, so this never locks, and the
+	// moved-from parameter is left with the default descriptor
+	swapDescriptors (other);
+}
+
+PluginParameter& PluginParameter::operator= (PluginParameter&& other) noexcept
+{
+	if (this != &other)
+	{
+		// the other parameter takes this one's old descriptor, and releases it
+		// from the pool when it's destroyed
+		swapDescriptors (other);
+		
+		setValueInternal (bitsToDouble (other.valueBits.get()));
+		smoothValue = other.smoothValue;
+	}
+	
+	return *this;
+}
+#endif
+
+void PluginParameter::swapDescriptors (PluginParameter& other) noexcept
+{
+	if (descriptor != other.descriptor)
+	{
+		const PluginParameterDescriptor::Ptr temp (descriptor);
+		descriptor = other.descriptor;
+		other.descriptor = temp;
+		
+		textCache.invalidate();
+		other.textCache.invalidate();
+	}
+}
+
+PluginParameter::~PluginParameter()
+{
+	PluginParameterDescriptor::releaseShared (descriptor);
+}
+
+void PluginParameter::copyValueFrom (const PluginParameter& other)
+{
+	setValue (bitsToDouble (other.valueBits.get()));
+	smoothValue = jlimit (descriptor->min, descriptor->max, other.smoothValue);
 }
 
 void PluginParameter::init(const String& name_, ParameterUnit unit_, String description_,
                            double value_, double min_, double max_, double default_,
                            double skewFactor_, double smoothCoeff_, double step_, String unitSuffix_)
 {
-	name = name_;
-	unit = unit_;
-	description = description_;
+	PluginParameterDescriptor newDescriptor;
 	
-	min = min_;
-	max = max_;
-	setValue (value_);
-	defaultValue = default_;
+	// keep any identifier that's already been set
+	newDescriptor.name = name_;
+	newDescriptor.identifier = (descriptor != nullptr) ? descriptor->identifier : String::empty;
+	newDescriptor.identifierHash = PluginParameterIndex::hashIdentifier (newDescriptor.identifier.isNotEmpty() ? newDescriptor.identifier
+	                                                                                                        : name_);
+	newDescriptor.unit = unit_;
+	newDescriptor.description = description_;
 	
-	smoothCoeff = smoothCoeff_;
-	smoothValue = getValue();
+	newDescriptor.min = min_;
+	newDescriptor.max = max_;
+	newDescriptor.defaultValue = default_;
 	
-	skewFactor = skewFactor_;
-	step = step_;
+	newDescriptor.smoothCoeff = smoothCoeff_;
+	newDescriptor.skewFactor = skewFactor_;
+	newDescriptor.step = step_;
 	
-	unitSuffix = unitSuffix_;
+	newDescriptor.unitSuffix = unitSuffix_;
 	
 	// default label suffix's, these can be changed later
-	switch (unit)
+	switch (unit_)
 	{
-		case UnitPercent:       setUnitSuffix("%");                             break;
-		case UnitSeconds:       setUnitSuffix("s");                             break;
-		case UnitPhase:         setUnitSuffix(CharPointer_UTF8 ("\xc2\xb0"));   break;
-		case UnitHertz:         setUnitSuffix("Hz");                            break;
-		case UnitDecibels:      setUnitSuffix("dB");                            break;
-		case UnitDegrees:       setUnitSuffix(CharPointer_UTF8 ("\xc2\xb0"));   break;
-		case UnitMeters:        setUnitSuffix("m");                             break;
-		case UnitBPM:           setUnitSuffix("BPM");                           break;
-		case UnitMilliseconds:  setUnitSuffix("ms");                            break;
-		default:                                                                break;
-	}	
+		case UnitPercent:       newDescriptor.unitSuffix = "%";                             break;
+		case UnitSeconds:       newDescriptor.unitSuffix = "s";                             break;
+		case UnitPhase:         newDescriptor.unitSuffix = CharPointer_UTF8 ("\xc2\xb0");   break;
+		case UnitHertz:         newDescriptor.unitSuffix = "Hz";                            break;
+		case UnitDecibels:      newDescriptor.unitSuffix = "dB";                            break;
+		case UnitDegrees:       newDescriptor.unitSuffix = CharPointer_UTF8 ("\xc2\xb0");   break;
+		case UnitMeters:        newDescriptor.unitSuffix = "m";                             break;
+		case UnitBPM:           newDescriptor.unitSuffix = "BPM";                           break;
+		case UnitMilliseconds:  newDescriptor.unitSuffix = "ms";                            break;
+		default:                                                                            break;
+	}
+	
+	setDescriptor (newDescriptor);
+	
+	setValue (value_);
+	smoothValue = getValue();
+}
+
+void PluginParameter::setDescriptor (const PluginParameterDescriptor& newDescriptor)
+{
+	// share the properties with any other parameters that have the same ones
+	PluginParameterDescriptor::releaseShared (descriptor);
+	descriptor = PluginParameterDescriptor::getShared (newDescriptor);
+	
+	textCache.invalidate();
 }
 
 void PluginParameter::setValue(double value)
 {
-	valueObject = jlimit (min, max, value);
+	setValueInternal (jlimit (descriptor->min, descriptor->max, value));
+}
+
+void PluginParameter::setValueInternal (double newValue)
+{
+	valueBits.set (doubleToBits (newValue));
+	
+	// the Value isn't thread-safe, so other threads leave it for updateValueObject()
+	if (MessageManager::existsAndIsCurrentThread())
+		valueObject = newValue;
+}
+
+void PluginParameter::updateValueObject()
+{
+	valueObject = getValue();
 }
 
 void PluginParameter::setNormalisedValue(double normalisedValue)
 {
-	setValue ((max - min) * jlimit (0.0, 1.0, normalisedValue) + min);
+	setValue ((descriptor->max - descriptor->min) * jlimit (0.0, 1.0, normalisedValue) + descriptor->min);
+}
+
+void PluginParameter::setIdentifier (const String& newIdentifier)
+{
+	PluginParameterDescriptor newDescriptor (*descriptor);
+	newDescriptor.identifier = newIdentifier;
+	newDescriptor.identifierHash = PluginParameterIndex::hashIdentifier (newIdentifier.isNotEmpty() ? newIdentifier
+	                                                                                                : newDescriptor.name);
+	setDescriptor (newDescriptor);
 }
 
 void PluginParameter::setUnitSuffix(String newSuffix)
 {
-	unitSuffix = newSuffix;
+	PluginParameterDescriptor newDescriptor (*descriptor);
+	newDescriptor.unitSuffix = newSuffix;
+	setDescriptor (newDescriptor);
+}
+
+void PluginParameter::copyTextUTF8 (char* dest, int maxBytes)
+{
+	textCache.copyText (getValue(), descriptor->min, descriptor->step, descriptor->unitSuffix, dest, maxBytes);
+}
+
+const String PluginParameter::getText()
+{
+	char text [PluginParameterText::maxLength];
+	copyTextUTF8 (text, sizeof (text));
+	
+	return String::fromUTF8 (text);
+}
+
+bool PluginParameter::getNormalisedValueFromText (const char* text, double& normalisedValue)
+{
+	double newValue;
+	
+	if (! PluginParameterText::parseText (text, descriptor->unit, descriptor->unitSuffix, newValue))
+		return false;
+	
+	normalisedValue = jlimit (0.0, 1.0, normaliseValue (newValue));
+	return true;
+}
+
+bool PluginParameter::setValueFromText (const char* text)
+{
+	double normalisedValue;
+	
+	if (! getNormalisedValueFromText (text, normalisedValue))
+		return false;
+	
+	setNormalisedValue (normalisedValue);
+	return true;
 }
 
 void PluginParameter::smooth()
 {
 	if (smoothValue != getValue())
 	{
+		const double smoothCoeff = descriptor->smoothCoeff;
+		
 		if( (smoothCoeff == 1.0) || almostEqual (smoothValue, getValue()) )
 			smoothValue = getValue(); 
 		else
@@ -103,48 +242,77 @@ void PluginParameter::smooth()
 	}
 }
 
+void PluginParameter::smooth (double numSteps)
+{
+	if (smoothValue != getValue())
+	{
+		const double smoothCoeff = descriptor->smoothCoeff;
+		
+		if( (smoothCoeff == 1.0) || almostEqual (smoothValue, getValue()) )
+			smoothValue = getValue();
+		else
+			smoothValue = ((getValue() - smoothValue) * (1.0 - pow (1.0 - smoothCoeff, numSteps))) + smoothValue;
+	}
+}
+
+void PluginParameter::resetSmoothing()
+{
+	smoothValue = getValue();
+}
+
 void PluginParameter::setSmoothCoeff (double newSmoothCoef)
 {
-	smoothCoeff = newSmoothCoef;
+	PluginParameterDescriptor newDescriptor (*descriptor);
+	newDescriptor.smoothCoeff = newSmoothCoef;
+	setDescriptor (newDescriptor);
 }
 
 void PluginParameter::setSkewFactor (double newSkewFactor)
 {
-	skewFactor = newSkewFactor;
+	PluginParameterDescriptor newDescriptor (*descriptor);
+	newDescriptor.skewFactor = newSkewFactor;
+	setDescriptor (newDescriptor);
 }
 
 void PluginParameter::setSkewFactorFromMidPoint (const double valueToShowAtMidPoint)
 {
+	const double min = descriptor->min, max = descriptor->max;
+	
 	if (max > min)
-        skewFactor = log (0.5) / log ((valueToShowAtMidPoint - min) / (max - min));
+        setSkewFactor (log (0.5) / log ((valueToShowAtMidPoint - min) / (max - min)));
 }
 
 void PluginParameter::setStep (double newStep)
 {
-	step = newStep;
+	PluginParameterDescriptor newDescriptor (*descriptor);
+	newDescriptor.step = newStep;
+	setDescriptor (newDescriptor);
 }
 
 void PluginParameter::writeXml (XmlElement& xmlState)
 {
-	xmlState.setAttribute (name, getValue());
+	xmlState.setAttribute (getIdentifier(), getValue());
 }
 
 void PluginParameter::readXml(const XmlElement* xmlState)
 {
-	setValue (xmlState->getDoubleAttribute (name, getValue()));
+	// older state was saved using the name
+	const String attributeName (xmlState->hasAttribute (getIdentifier()) ? getIdentifier() : getName());
+	
+	setValue (xmlState->getDoubleAttribute (attributeName, getValue()));
 }
 
 void PluginParameter::setupSlider(Slider &slider)
 {
-    slider.setRange             (min, max, step);
-    slider.setSkewFactor        (skewFactor);
+    slider.setRange             (descriptor->min, descriptor->max, descriptor->step);
+    slider.setSkewFactor        (descriptor->skewFactor);
     slider.setValue             (getValue(), false);
-    slider.setTextValueSuffix   (unitSuffix);
+    slider.setTextValueSuffix   (descriptor->unitSuffix);
 }
 
 double PluginParameter::normaliseValue(double scaledValue)
 {
-	return ((scaledValue - min) / (max - min));
+	return ((scaledValue - descriptor->min) / (descriptor->max - descriptor->min));
 }
 
 //END_JUCE_NAMESPACE
\ No newline at end of file
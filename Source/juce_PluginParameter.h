@@ -29,11 +29,18 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "juce_PluginParameterHelpers.h"
+#include "juce_PluginParameterText.h"
+#include "juce_PluginParameterDescriptor.h"
 
 /**	This file defines a parameter used in an application.
  
 	Both full-scale and normalised values must be present for
 	AU and VST host campatability.
+ 
+	The name, range and other fixed properties are held in a
+	PluginParameterDescriptor that's shared with any identical
+	parameters in other instances of the plugin, so each parameter
+	only holds its own value and smoothing state.
  */
 class PluginParameter
 {
@@ -48,9 +55,33 @@ public:
 	PluginParameter();
 
     /** Creates a copy of another parameter.
+		This shares the other parameter's descriptor, so it's just a pointer
+		and value copy.
      */
     PluginParameter (const PluginParameter& other);
     
+	/** Makes this parameter a copy of another one. */
+	PluginParameter& operator= (const PluginParameter& other);
+	
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+	/** Takes over another parameter's descriptor and value. These don't lock or
+		allocate. A moved-from parameter is left with the default descriptor from
+		PluginParameterDescriptor::getDefault(), or when assigning, with the
+		descriptor this one had before.
+	 */
+	PluginParameter (PluginParameter&& other) noexcept;
+	PluginParameter& operator= (PluginParameter&& other) noexcept;
+   #endif
+	
+	/** Destructor. */
+	~PluginParameter();
+	
+	/** Copies just the value and smoothing state of another parameter, leaving
+		this one's name, range and other properties alone. The value is clipped
+		to this parameter's range.
+	 */
+	void copyValueFrom (const PluginParameter& other);
+	
 	/** Initialise the parameter.
 		Used to set up the parameter as required.
 	 */
@@ -58,35 +89,92 @@ public:
                double value_, double min_ =0.0f, double max_ =1.0f, double default_ =0.0f,
                double skewFactor_ =1.0f, double smoothCoeff_ =0.1f, double step_ =0.01, String unitSuffix_ =String::empty);
 
+	/** Returns a Value that mirrors the parameter, e.g. for showing it in a Slider.
+	 
+		The parameter's own value is held atomically, so getValue() and setValue()
+		can be used from the audio thread while a host sets the parameter from
+		another one. A Value can't be shared like that, so this one is only changed
+		by calls made on the message thread. Call updateValueObject() from there
+		(e.g. in an editor's timer) to pick up changes made on other threads.
+		Changing the Value doesn't change the parameter.
+	 */
     inline Value& getValueObject()                              {   return valueObject;     }
+	
+	/** Copies the current value into the Value returned by getValueObject().
+		Only call this on the message thread.
+	 */
+	void updateValueObject();
     
-	inline double getValue()                                    {   return double (valueObject.getValue()); }
+	inline double getValue()                                    {   return bitsToDouble (valueBits.get());  }
 	inline double getNormalisedValue()                          {   return normaliseValue (getValue());     }
 	void setValue (double value_);
 	void setNormalisedValue (double normalisedValue);
 	inline double getSmoothedValue()                            {   return smoothValue;     }
 	inline double getSmoothedNormalisedValue()                  {   return normaliseValue (smoothValue);     }
 	
-	inline double getMin()                                      {   return min;             }
-	inline double getMax()                                      {   return max;             }
-	inline double getDefault()                                  {   return defaultValue;    }
+	inline double getMin()                                      {   return descriptor->min;             }
+	inline double getMax()                                      {   return descriptor->max;             }
+	inline double getDefault()                                  {   return descriptor->defaultValue;    }
 	
 	void smooth();
+	/** Smooths by a fraction (or multiple) of one smooth() step.
+		Use this when a block is split into pieces, giving each piece its share of
+		the block, so the smoothing time doesn't depend on how many pieces there are.
+	 */
+	void smooth (double numSteps);
+	/** Jumps the smoothed value straight to the current value. */
+	void resetSmoothing();
 	void setSmoothCoeff (double newSmoothCoef);
-	inline double getSmoothCoeff()                              {   return smoothCoeff;     }
+	inline double getSmoothCoeff()                              {   return descriptor->smoothCoeff;     }
 	
 	void setSkewFactor (const double newSkewFactor);
 	void setSkewFactorFromMidPoint (const double valueToShowAtMidPoint);
-	inline double getSkewFactor()                               {   return skewFactor;      }
+	inline double getSkewFactor()                               {   return descriptor->skewFactor;      }
 	
 	void setStep (double newStep);
-	inline double getStep()                                     {   return step;            }
+	inline double getStep()                                     {   return descriptor->step;            }
+	
+	inline const String getName()                               {   return descriptor->name;            }
 	
-	inline const String getName()                               {   return name;            }
-	inline ParameterUnit getUnit()                              {   return unit;            }
-	inline const String getUnitSuffix()                         {   return unitSuffix;      }
+	/** Sets a stable identifier for the parameter, which is used instead of its
+		name when saving and loading state. This means the parameter can be
+		renamed without breaking old sessions, as long as the identifier stays
+		the same. If this isn't called the name is used.
+	 */
+	void setIdentifier (const String& newIdentifier);
+	inline const String getIdentifier()                         {   return descriptor->identifier.isNotEmpty() ? descriptor->identifier : descriptor->name; }
+	
+	/** Returns the hash of the identifier that's stored in binary state.
+		@see PluginParameterIndex
+	 */
+	inline uint32 getIdentifierHash() const noexcept            {   return descriptor->identifierHash;  }
+	inline ParameterUnit getUnit()                              {   return descriptor->unit;            }
+	inline const String getUnitSuffix()                         {   return descriptor->unitSuffix;      }
 	void setUnitSuffix (String newSuffix);
 	
+	/** Copies the current value as display text, e.g. "-6.0 dB", into a buffer.
+		The text is cached, so while the value stays on the same step this is
+		just a compare and a copy.
+	 */
+	void copyTextUTF8 (char* dest, int maxBytes);
+	
+	/** Returns the current value as display text. */
+	const String getText();
+	
+	/** Reads some text typed by a user, e.g. "1.5k", "-6 dB" or "C3", as a
+		normalised value, limiting it to the parameter's range.
+		Returns false if the text couldn't be read.
+		@see PluginParameterText::parseText
+	 */
+	bool getNormalisedValueFromText (const char* text, double& normalisedValue);
+	
+	/** Sets the value from some text typed by a user, limited to the parameter's range.
+		Returns false and leaves the value alone if the text couldn't be read.
+		This only changes this parameter, so in a plugin use
+		AudioProcessorExt::setParameterFromText() instead.
+	 */
+	bool setValueFromText (const char* text);
+	
 	void writeXml (XmlElement& xmlState);
 	void readXml (const XmlElement* xmlState);
 	
@@ -94,16 +182,24 @@ public:
      */
 	void setupSlider (Slider& slider);
 	
+	/** Returns the shared properties of the parameter. */
+	inline const PluginParameterDescriptor& getDescriptor() const noexcept  {   return *descriptor;     }
+	
 private:
     
+    Atomic<int64> valueBits;
     Value valueObject;
-	String name, description, unitSuffix;
-	double min, max, defaultValue;
-	double smoothCoeff, smoothValue;
-	double skewFactor, step;
-	ParameterUnit unit;
+	PluginParameterDescriptor::Ptr descriptor;
+	double smoothValue;
+	PluginParameterText textCache;
 	
     double normaliseValue (double scaledValue);
+	void setValueInternal (double newValue);
+	void swapDescriptors (PluginParameter& other) noexcept;
+	
+	static inline int64 doubleToBits (double value) noexcept    {   int64 bits; memcpy (&bits, &value, sizeof (bits)); return bits;     }
+	static inline double bitsToDouble (int64 bits) noexcept     {   double value; memcpy (&value, &bits, sizeof (value)); return value; }
+	void setDescriptor (const PluginParameterDescriptor& newDescriptor);
 
 	JUCE_LEAK_DETECTOR (PluginParameter);
 };
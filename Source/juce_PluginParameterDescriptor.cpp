@@ -0,0 +1,240 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterDescriptor.h"
+
+namespace PluginParameterDescriptorHelpers
+{
+    /** The shared descriptors, in buckets keyed on their identifier hashes, so a
+        lookup only compares against the few descriptors for the same identifier
+        rather than every one in the pool. This isn't thread-safe by itself, so
+        always use it with the lock from getPoolLock().
+     */
+    class Pool
+    {
+    public:
+        Pool() : numDescriptors (0)
+        {
+            setNumBuckets (64);
+        }
+
+        int size() const noexcept       { return numDescriptors; }
+
+        PluginParameterDescriptor* find (const PluginParameterDescriptor& descriptor) const noexcept
+        {
+            const ReferenceCountedArray<PluginParameterDescriptor>& bucket = getBucket (descriptor.identifierHash);
+
+            for (int i = bucket.size(); --i >= 0;)
+            {
+                PluginParameterDescriptor* const d = bucket.getUnchecked (i);
+
+                if (d == &descriptor || *d == descriptor)
+                    return d;
+            }
+
+            return nullptr;
+        }
+
+        void add (PluginParameterDescriptor* const descriptor)
+        {
+            // keep the buckets short as the pool grows
+            if (numDescriptors >= buckets.size() * 2)
+                setNumBuckets (buckets.size() * 4);
+
+            getBucket (descriptor->identifierHash).add (descriptor);
+            ++numDescriptors;
+        }
+
+        void remove (PluginParameterDescriptor* const descriptor)
+        {
+            ReferenceCountedArray<PluginParameterDescriptor>& bucket = getBucket (descriptor->identifierHash);
+            const int index = bucket.indexOf (descriptor);
+
+            if (index >= 0)
+            {
+                bucket.remove (index);
+                --numDescriptors;
+            }
+        }
+
+    private:
+        OwnedArray<ReferenceCountedArray<PluginParameterDescriptor> > buckets;
+        int numDescriptors;
+
+        ReferenceCountedArray<PluginParameterDescriptor>& getBucket (const uint32 hash) const noexcept
+        {
+            // the bucket count is always a power of two
+            return *buckets.getUnchecked ((int) (hash & (uint32) (buckets.size() - 1)));
+        }
+
+        void setNumBuckets (const int numBuckets)
+        {
+            OwnedArray<ReferenceCountedArray<PluginParameterDescriptor> > oldBuckets;
+            oldBuckets.swapWithArray (buckets);
+
+            for (int i = 0; i < numBuckets; ++i)
+                buckets.add (new ReferenceCountedArray<PluginParameterDescriptor>());
+
+            for (int i = 0; i < oldBuckets.size(); ++i)
+            {
+                const ReferenceCountedArray<PluginParameterDescriptor>& oldBucket = *oldBuckets.getUnchecked (i);
+
+                for (int j = 0; j < oldBucket.size(); ++j)
+                    getBucket (oldBucket.getUnchecked (j)->identifierHash).add (oldBucket.getUnchecked (j));
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Pool);
+    };
+
+    CriticalSection& getPoolLock()
+    {
+        static CriticalSection lock;
+        return lock;
+    }
+
+    Pool& getPool()
+    {
+        static Pool pool;
+        return pool;
+    }
+}
+
+//==============================================================================
+PluginParameterDescriptor::PluginParameterDescriptor()
+    : identifierHash (0),
+      min (0.0),
+      max (1.0),
+      defaultValue (0.0),
+      smoothCoeff (0.1),
+      skewFactor (1.0),
+      step (0.01),
+      unit (UnitGeneric)
+{
+}
+
+PluginParameterDescriptor::PluginParameterDescriptor (const PluginParameterDescriptor& other)
+    : ReferenceCountedObject(),
+      name (other.name),
+      identifier (other.identifier),
+      description (other.description),
+      unitSuffix (other.unitSuffix),
+      identifierHash (other.identifierHash),
+      min (other.min),
+      max (other.max),
+      defaultValue (other.defaultValue),
+      smoothCoeff (other.smoothCoeff),
+      skewFactor (other.skewFactor),
+      step (other.step),
+      unit (other.unit)
+{
+}
+
+PluginParameterDescriptor::~PluginParameterDescriptor()
+{
+}
+
+//==============================================================================
+bool PluginParameterDescriptor::operator== (const PluginParameterDescriptor& other) const noexcept
+{
+    return identifierHash == other.identifierHash
+            && min == other.min
+            && max == other.max
+            && defaultValue == other.defaultValue
+            && smoothCoeff == other.smoothCoeff
+            && skewFactor == other.skewFactor
+            && step == other.step
+            && unit == other.unit
+            && name == other.name
+            && identifier == other.identifier
+            && unitSuffix == other.unitSuffix
+            && description == other.description;
+}
+
+bool PluginParameterDescriptor::operator!= (const PluginParameterDescriptor& other) const noexcept
+{
+    return ! operator== (other);
+}
+
+//==============================================================================
+PluginParameterDescriptor::Ptr PluginParameterDescriptor::getShared (const PluginParameterDescriptor& descriptor)
+{
+    using namespace PluginParameterDescriptorHelpers;
+
+    const ScopedLock sl (getPoolLock());
+    Pool& pool = getPool();
+
+    PluginParameterDescriptor* const existing = pool.find (descriptor);
+
+    if (existing != nullptr)
+        return existing;
+
+    PluginParameterDescriptor* const newDescriptor = new PluginParameterDescriptor (descriptor);
+    pool.add (newDescriptor);
+    return newDescriptor;
+}
+
+void PluginParameterDescriptor::releaseShared (Ptr& descriptor)
+{
+    using namespace PluginParameterDescriptorHelpers;
+
+    if (descriptor == nullptr)
+        return;
+
+    // every reference to a shared descriptor is taken and dropped with this lock
+    // held, so nothing can pick this one up between the check and the removal
+    const ScopedLock sl (getPoolLock());
+
+    // if only the pool and this pointer are left it's no longer being used
+    if (descriptor->getReferenceCount() == 2)
+        getPool().remove (descriptor);
+
+    descriptor = nullptr;
+}
+
+const PluginParameterDescriptor::Ptr& PluginParameterDescriptor::getDefault()
+{
+    // holding a reference here keeps it in the pool until the program exits
+    static const Ptr defaultDescriptor (getShared (PluginParameterDescriptor()));
+    return defaultDescriptor;
+}
+
+namespace PluginParameterDescriptorHelpers
+{
+    // creates the default descriptor while the program starts up, so that a
+    // PluginParameter's noexcept move never has to lock the pool or allocate
+    const PluginParameterDescriptor::Ptr& defaultDescriptorAtStartup = PluginParameterDescriptor::getDefault();
+}
+
+int PluginParameterDescriptor::getNumShared()
+{
+    using namespace PluginParameterDescriptorHelpers;
+
+    const ScopedLock sl (getPoolLock());
+    return getPool().size();
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERDESCRIPTOR_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERDESCRIPTOR_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameterHelpers.h"
+
+//==============================================================================
+/**
+    The parts of a parameter that don't change while the plugin is running: its
+    name, range, unit and so on.
+
+    These are the same for every instance of a plugin, so rather than each
+    PluginParameter having its own copy they're shared. getShared() returns a
+    descriptor from a global pool if an identical one already exists, so with
+    many instances loaded there's only one set of names and ranges per
+    parameter, and each PluginParameter just holds a pointer to it along with
+    its own value and smoothing state.
+
+    Once a descriptor has been shared it must never be changed, as other
+    parameters may be using it. To change one, copy it, change the copy and
+    share that instead.
+
+    @see PluginParameter
+ */
+class PluginParameterDescriptor  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** Creates a descriptor with some standard default values. */
+    PluginParameterDescriptor();
+
+    /** Creates a copy of another descriptor. The copy isn't shared. */
+    PluginParameterDescriptor (const PluginParameterDescriptor& other);
+
+    /** Destructor. */
+    ~PluginParameterDescriptor();
+
+    typedef ReferenceCountedObjectPtr<PluginParameterDescriptor> Ptr;
+
+    //==============================================================================
+    /** Returns true if all the properties of the two descriptors are the same. */
+    bool operator== (const PluginParameterDescriptor& other) const noexcept;
+    bool operator!= (const PluginParameterDescriptor& other) const noexcept;
+
+    /** Returns a shared descriptor identical to this one, adding a copy to the
+        pool if there isn't one already.
+
+        The pool is keyed on identifierHash, so this only compares against
+        descriptors with the same identifier. Use this to take another
+        reference to a descriptor that's already shared, rather than copying
+        the pointer, so releaseShared() can tell when it's no longer used.
+     */
+    static Ptr getShared (const PluginParameterDescriptor& descriptor);
+
+    /** Lets go of a shared descriptor, removing it from the pool if nothing else
+        is using it. The pointer is set to nullptr.
+     */
+    static void releaseShared (Ptr& descriptor);
+
+    /** Returns the number of descriptors in the pool. */
+    static int getNumShared();
+
+    /** Returns a shared descriptor with the default values.
+        This is never removed from the pool, so the pointer can be copied freely.
+        It's created when the program starts up, so after that this doesn't
+        lock or allocate. It's what a moved-from PluginParameter is left with.
+     */
+    static const Ptr& getDefault();
+
+    //==============================================================================
+    String name, identifier, description, unitSuffix;
+    uint32 identifierHash;
+    double min, max, defaultValue;
+    double smoothCoeff, skewFactor, step;
+    ParameterUnit unit;
+
+private:
+    //==============================================================================
+    PluginParameterDescriptor& operator= (const PluginParameterDescriptor&);
+
+    JUCE_LEAK_DETECTOR (PluginParameterDescriptor);
+};
+
+#endif //__JUCE_PLUGINPARAMETERDESCRIPTOR_JUCEHEADER__
@@ -0,0 +1,187 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterEventList.h"
+
+float PluginParameterEventList::Event::getValueAt (const int sample) const noexcept
+{
+    if (rampLength <= 0 || sample >= getEndSample())
+        return endValue;
+
+    if (sample <= sampleOffset)
+        return startValue;
+
+    const float proportion = (sample - sampleOffset) / (float) rampLength;
+    return startValue + (endValue - startValue) * proportion;
+}
+
+//==============================================================================
+PluginParameterEventList::PluginParameterEventList (const int maxNumEvents)
+    : numEvents (0), capacity (0), numApplied (0), rampStepSize (32), numDropped (0)
+{
+    setCapacity (maxNumEvents);
+}
+
+PluginParameterEventList::~PluginParameterEventList()
+{
+}
+
+void PluginParameterEventList::setCapacity (const int maxNumEvents)
+{
+    capacity = jmax (0, maxNumEvents);
+    events.malloc ((size_t) jmax (1, capacity));
+    clear();
+}
+
+//==============================================================================
+void PluginParameterEventList::clear() noexcept
+{
+    numEvents = 0;
+    numApplied = 0;
+}
+
+bool PluginParameterEventList::addChange (const int parameterIndex, const float newValue, const int sampleOffset) noexcept
+{
+    Event e;
+    e.parameterIndex = parameterIndex;
+    e.sampleOffset = sampleOffset;
+    e.rampLength = 0;
+    e.startValue = newValue;
+    e.endValue = newValue;
+
+    return add (e);
+}
+
+bool PluginParameterEventList::addRamp (const int parameterIndex, const float startValue, const float endValue,
+                                        const int sampleOffset, const int numSamples) noexcept
+{
+    Event e;
+    e.parameterIndex = parameterIndex;
+    e.sampleOffset = sampleOffset;
+    e.rampLength = jmax (0, numSamples);
+    e.startValue = startValue;
+    e.endValue = endValue;
+
+    return add (e);
+}
+
+bool PluginParameterEventList::add (const Event& newEvent) noexcept
+{
+    if (numEvents >= capacity)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    // events nearly always arrive in order, so this is usually just an append.
+    // Changes for the same sample stay in the order they were added.
+    int i = numEvents;
+
+    while (i > numApplied && events[i - 1].sampleOffset > newEvent.sampleOffset)
+    {
+        events[i] = events[i - 1];
+        --i;
+    }
+
+    events[i] = newEvent;
+    ++numEvents;
+    return true;
+}
+
+void PluginParameterEventList::takeEventsFrom (PluginParameterEventList& other) noexcept
+{
+    for (int i = 0; i < other.numEvents; ++i)
+        add (other.events[i]);
+
+    other.clear();
+}
+
+const PluginParameterEventList::Event& PluginParameterEventList::getEvent (const int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numEvents));
+    return events [index];
+}
+
+//==============================================================================
+int PluginParameterEventList::applyChanges (const int startSample, const int blockSize, Target& target) noexcept
+{
+    // apply any jumps that have become due since the last call, and the final
+    // values of any ramps that were over before we got to them
+    while (numApplied < numEvents && events[numApplied].sampleOffset <= startSample)
+    {
+        const Event& e = events [numApplied++];
+
+        if (e.rampLength == 0 || e.getEndSample() < startSample)
+            target.setScheduledValue (e.parameterIndex, e.endValue);
+    }
+
+    int nextChange = blockSize;
+
+    if (numApplied < numEvents)
+        nextChange = jmin (nextChange, events[numApplied].sampleOffset);
+
+    // then move along any ramps that are still going
+    for (int i = 0; i < numApplied; ++i)
+    {
+        const Event& e = events[i];
+
+        if (e.rampLength > 0 && e.sampleOffset <= startSample && startSample <= e.getEndSample())
+            target.setScheduledValue (e.parameterIndex, e.getValueAt (startSample));
+
+        if (e.rampLength > 0 && startSample < e.getEndSample())
+            nextChange = jmin (nextChange, startSample + rampStepSize, e.getEndSample());
+    }
+
+    const int numSamples = jmax (1, nextChange - startSample);
+
+    if (startSample + numSamples >= blockSize)
+        advance (blockSize);
+
+    return numSamples;
+}
+
+void PluginParameterEventList::advance (const int blockSize) noexcept
+{
+    int numKept = 0;
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        Event e (events[i]);
+
+        // keep changes that are still to come, and ramps that haven't had their
+        // final value applied yet
+        if (e.sampleOffset >= blockSize || (e.rampLength > 0 && e.getEndSample() >= blockSize))
+        {
+            e.sampleOffset -= blockSize;
+            events [numKept++] = e;
+        }
+    }
+
+    numEvents = numKept;
+    numApplied = 0;
+}
+
+//END_JUCE_NAMESPACE
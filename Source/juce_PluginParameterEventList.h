@@ -0,0 +1,153 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETEREVENTLIST_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETEREVENTLIST_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A list of parameter changes, each timed to a sample within a block.
+
+    Some hosts tell a plugin exactly which sample an automation change belongs
+    to, or ask for a parameter to ramp between two values over a number of
+    samples. The plugin wrappers add these to a list, and the processor then
+    splits each block at the changes with applyChanges(), so automation is as
+    accurate as it would be with tiny host buffers.
+
+    All the memory is allocated by setCapacity(), so adding, applying and
+    advancing never allocate. Events that don't fit are dropped and counted.
+    None of the methods lock, so only use a list from one thread at a time.
+
+    @see AudioProcessorExt::scheduleParameterChange
+ */
+class PluginParameterEventList
+{
+public:
+    //==============================================================================
+    /** A change to a parameter, which may be a jump or a ramp. */
+    struct Event
+    {
+        int parameterIndex;
+        int sampleOffset;       /**< The sample the change starts at, from the start of the block. */
+        int rampLength;         /**< The length of the ramp in samples, or 0 for a jump. */
+        float startValue, endValue;
+
+        /** Returns the sample the change finishes at. */
+        int getEndSample() const noexcept           { return sampleOffset + rampLength; }
+
+        /** Returns the value the parameter should have at a sample in the block. */
+        float getValueAt (int sample) const noexcept;
+    };
+
+    //==============================================================================
+    /** Something changes are applied to, see applyChanges(). */
+    class Target
+    {
+    public:
+        virtual ~Target() {}
+
+        /** Called to set a parameter to a value given in its full-scale range. */
+        virtual void setScheduledValue (int parameterIndex, float newValue) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a list with room for a number of events. */
+    explicit PluginParameterEventList (int maxNumEvents = 0);
+
+    /** Destructor. */
+    ~PluginParameterEventList();
+
+    //==============================================================================
+    /** Allocates room for a number of events, and clears the list. */
+    void setCapacity (int maxNumEvents);
+
+    /** Returns the number of events the list has room for. */
+    int getCapacity() const noexcept                { return capacity; }
+
+    /** Sets how often ramps are updated by applyChanges(), in samples.
+        The default is 32, and the parameter's own smoothing fills in the rest.
+     */
+    void setRampStepSize (int numSamples) noexcept  { rampStepSize = jmax (1, numSamples); }
+
+    //==============================================================================
+    /** Removes all the events. */
+    void clear() noexcept;
+
+    /** Adds a jump to a new value at a sample in the block.
+        Returns false and counts the event as dropped if the list is full.
+     */
+    bool addChange (int parameterIndex, float newValue, int sampleOffset) noexcept;
+
+    /** Adds a ramp between two values, which can start before the block
+        (i.e. with a negative offset) and carry on into later ones.
+        Returns false and counts the event as dropped if the list is full.
+     */
+    bool addRamp (int parameterIndex, float startValue, float endValue,
+                  int sampleOffset, int numSamples) noexcept;
+
+    /** Adds an event, keeping the list in time order. */
+    bool add (const Event& newEvent) noexcept;
+
+    /** Moves all the events from another list into this one, and clears it. */
+    void takeEventsFrom (PluginParameterEventList& other) noexcept;
+
+    //==============================================================================
+    /** Returns the number of events in the list. */
+    int getNumEvents() const noexcept               { return numEvents; }
+
+    /** Returns one of the events, which are kept in time order. */
+    const Event& getEvent (int index) const noexcept;
+
+    /** Returns the number of events that have been dropped because the list was full. */
+    int getNumDropped() const noexcept              { return numDropped; }
+
+    //==============================================================================
+    /** Applies everything that's due at a sample in the block, and returns the
+        number of samples before anything else changes.
+
+        Call this with a startSample of 0, process the number of samples it
+        returns, then call it again from there until you reach the end of the
+        block. Changes that become due are applied once, and ramps are applied
+        every few samples (see setRampStepSize()) until they finish. Once the
+        end of the block is reached, advance() is called for you.
+     */
+    int applyChanges (int startSample, int blockSize, Target& target) noexcept;
+
+    /** Moves on to the next block, removing the events that have finished and
+        making the others relative to the start of the next block.
+     */
+    void advance (int blockSize) noexcept;
+
+private:
+    //==============================================================================
+    HeapBlock<Event> events;
+    int numEvents, capacity, numApplied, rampStepSize, numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterEventList);
+};
+
+#endif //__JUCE_PLUGINPARAMETEREVENTLIST_JUCEHEADER__
@@ -0,0 +1,86 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterFrame.h"
+
+PluginParameterFrame::PluginParameterFrame()
+    : numParameters (0)
+{
+}
+
+PluginParameterFrame::PluginParameterFrame (int numParameters_)
+    : numParameters (0)
+{
+    setNumParameters (numParameters_);
+}
+
+PluginParameterFrame::~PluginParameterFrame()
+{
+}
+
+void PluginParameterFrame::setNumParameters (int newNumParameters)
+{
+    newNumParameters = jmax (0, newNumParameters);
+
+    if (numParameters != newNumParameters)
+    {
+        numParameters = newNumParameters;
+        values.malloc ((size_t) numParameters);
+        isSet.malloc ((size_t) numParameters);
+    }
+
+    clear();
+}
+
+void PluginParameterFrame::clear() noexcept
+{
+    if (numParameters > 0)
+    {
+        zeromem (values, sizeof (double) * (size_t) numParameters);
+        zeromem (isSet, sizeof (bool) * (size_t) numParameters);
+    }
+}
+
+void PluginParameterFrame::setValue (int index, double newValue) noexcept
+{
+    if (isPositiveAndBelow (index, numParameters))
+    {
+        values[index] = newValue;
+        isSet[index] = true;
+    }
+}
+
+bool PluginParameterFrame::hasValue (int index) const noexcept
+{
+    return isPositiveAndBelow (index, numParameters) && isSet[index];
+}
+
+double PluginParameterFrame::getValue (int index) const noexcept
+{
+    return isPositiveAndBelow (index, numParameters) ? values[index] : 0.0;
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,91 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERFRAME_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERFRAME_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A snapshot of full-scale values for a set of parameters.
+
+    Frames are used to stage a complete set of values somewhere other than the
+    live parameters, for example while state is being decoded on a background
+    thread, so they can be applied all at once at a block boundary.
+
+    Each slot can be empty, in which case the parameter it refers to should be
+    left alone when the frame is applied.
+ */
+class PluginParameterFrame
+{
+public:
+    //==============================================================================
+    /** Creates an empty frame with no slots. */
+    PluginParameterFrame();
+
+    /** Creates a frame with a number of empty slots. */
+    explicit PluginParameterFrame (int numParameters);
+
+    /** Destructor. */
+    ~PluginParameterFrame();
+
+    //==============================================================================
+    /** Changes the number of slots and empties them all.
+        This only allocates if the number of slots changes.
+     */
+    void setNumParameters (int numParameters);
+
+    /** Returns the number of slots. */
+    int getNumParameters() const noexcept                   { return numParameters; }
+
+    /** Empties all the slots without changing how many there are. */
+    void clear() noexcept;
+
+    //==============================================================================
+    /** Sets the value of a slot. Indexes out of range are ignored. */
+    void setValue (int index, double newValue) noexcept;
+
+    /** Returns true if a slot has been given a value since the last clear(). */
+    bool hasValue (int index) const noexcept;
+
+    /** Returns the value of a slot, or 0 if it's empty or out of range. */
+    double getValue (int index) const noexcept;
+
+    /** Returns the values as a contiguous array of getNumParameters() doubles.
+        Empty slots hold 0.
+     */
+    const double* getRawValues() const noexcept             { return values; }
+
+private:
+    //==============================================================================
+    HeapBlock<double> values;
+    HeapBlock<bool> isSet;
+    int numParameters;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterFrame);
+};
+
+#endif //__JUCE_PLUGINPARAMETERFRAME_JUCEHEADER__
@@ -0,0 +1,401 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterGraph.h"
+
+PluginParameterGraph::PluginParameterGraph()
+    : numParameters (0),
+      numNodes (0),
+      isBuilt (false)
+{
+}
+
+PluginParameterGraph::~PluginParameterGraph()
+{
+}
+
+//==============================================================================
+void PluginParameterGraph::setNumParameters (const int newNumParameters)
+{
+    numParameters = jmax (0, newNumParameters);
+    numNodes = 0;
+    edges.clear();
+    isBuilt = false;
+}
+
+void PluginParameterGraph::addMacro (const int macroIndex, const int targetIndex, const float amount, const float offset)
+{
+    jassert (isPositiveAndBelow (macroIndex, numParameters) && isPositiveAndBelow (targetIndex, numParameters));
+    jassert (macroIndex != targetIndex);
+
+    const Edge e = { macroIndex, targetIndex, macroEdge, amount, offset };
+    edges.add (e);
+    isBuilt = false;
+}
+
+void PluginParameterGraph::addLink (const int firstIndex, const int secondIndex)
+{
+    jassert (isPositiveAndBelow (firstIndex, numParameters) && isPositiveAndBelow (secondIndex, numParameters));
+
+    const Edge forwards  = { firstIndex, secondIndex, linkEdge, 1.0f, 0.0f };
+    const Edge backwards = { secondIndex, firstIndex, linkEdge, 1.0f, 0.0f };
+    edges.add (forwards);
+    edges.add (backwards);
+    isBuilt = false;
+}
+
+void PluginParameterGraph::addMinMaxConstraint (const int minIndex, const int maxIndex)
+{
+    jassert (isPositiveAndBelow (minIndex, numParameters) && isPositiveAndBelow (maxIndex, numParameters));
+
+    const Edge pushMaxUp  = { minIndex, maxIndex, keepAboveEdge, 1.0f, 0.0f };
+    const Edge pushMinDown = { maxIndex, minIndex, keepBelowEdge, 1.0f, 0.0f };
+    edges.add (pushMaxUp);
+    edges.add (pushMinDown);
+    isBuilt = false;
+}
+
+//==============================================================================
+bool PluginParameterGraph::build()
+{
+    bool isAcyclic = true;
+    const size_t numSlots = (size_t) jmax (1, numParameters);
+
+    // parameters joined by links or constraints become a single node
+    HeapBlock<int> root (numSlots);
+
+    for (int i = 0; i < numParameters; ++i)
+        root[i] = i;
+
+    for (int i = 0; i < edges.size(); ++i)
+    {
+        const Edge& e = edges.getReference (i);
+
+        if (e.type != macroEdge)
+        {
+            int a = e.source, b = e.target;
+
+            while (root[a] != a)    a = root[a];
+            while (root[b] != b)    b = root[b];
+
+            root [jmax (a, b)] = jmin (a, b);
+        }
+    }
+
+    nodeForParameter.malloc (numSlots);
+    numNodes = 0;
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        int r = i;
+
+        while (root[r] != r)
+            r = root[r];
+
+        // roots always come before the rest of their node, so already have a number
+        nodeForParameter[i] = (r == i) ? numNodes++ : nodeForParameter[r];
+    }
+
+    // list the members of each node together
+    firstMember.calloc ((size_t) numNodes + 1);
+    members.malloc (numSlots);
+
+    for (int i = 0; i < numParameters; ++i)
+        ++firstMember [nodeForParameter[i] + 1];
+
+    for (int n = 0; n < numNodes; ++n)
+        firstMember[n + 1] += firstMember[n];
+
+    {
+        HeapBlock<int> fill (numSlots);
+
+        for (int n = 0; n < numNodes; ++n)
+            fill[n] = firstMember[n];
+
+        for (int i = 0; i < numParameters; ++i)
+            members [fill [nodeForParameter[i]]++] = i;
+    }
+
+    // a macro can't drive something it's joined to
+    for (int i = edges.size(); --i >= 0;)
+    {
+        const Edge& e = edges.getReference (i);
+
+        if (e.type == macroEdge && nodeForParameter [e.source] == nodeForParameter [e.target])
+        {
+            jassertfalse;
+            edges.remove (i);
+            isAcyclic = false;
+        }
+    }
+
+    // sort the nodes so every macro comes before its targets
+    nodeRank.malloc ((size_t) jmax (1, numNodes));
+
+    {
+        HeapBlock<int> numInputs ((size_t) jmax (1, numNodes), true);
+        HeapBlock<int> queue ((size_t) jmax (1, numNodes));
+        int queueStart = 0, queueEnd = 0;
+
+        for (int i = 0; i < edges.size(); ++i)
+            if (edges.getReference (i).type == macroEdge)
+                ++numInputs [nodeForParameter [edges.getReference (i).target]];
+
+        for (int n = 0; n < numNodes; ++n)
+        {
+            nodeRank[n] = -1;
+
+            if (numInputs[n] == 0)
+                queue [queueEnd++] = n;
+        }
+
+        while (queueStart < queueEnd)
+        {
+            const int n = queue [queueStart];
+            nodeRank[n] = queueStart++;
+
+            for (int i = 0; i < edges.size(); ++i)
+            {
+                const Edge& e = edges.getReference (i);
+
+                if (e.type == macroEdge && nodeForParameter [e.source] == n)
+                    if (--numInputs [nodeForParameter [e.target]] == 0)
+                        queue [queueEnd++] = nodeForParameter [e.target];
+            }
+        }
+
+        if (queueEnd < numNodes)
+        {
+            // some macros drive each other in a loop, so leave out the ones that
+            // are part of it and put the nodes involved at the end
+            jassertfalse;
+            isAcyclic = false;
+
+            for (int i = edges.size(); --i >= 0;)
+            {
+                const Edge& e = edges.getReference (i);
+
+                if (e.type == macroEdge && nodeRank [nodeForParameter [e.source]] < 0)
+                    edges.remove (i);
+            }
+
+            for (int n = 0; n < numNodes; ++n)
+                if (nodeRank[n] < 0)
+                    nodeRank[n] = queueEnd++;
+        }
+    }
+
+    // list the edges leaving each parameter together
+    firstEdge.calloc (numSlots + 1);
+    sortedEdges.malloc ((size_t) jmax (1, edges.size()));
+    isMeta.calloc (numSlots);
+
+    for (int i = 0; i < edges.size(); ++i)
+        ++firstEdge [edges.getReference (i).source + 1];
+
+    for (int i = 0; i < numParameters; ++i)
+        firstEdge[i + 1] += firstEdge[i];
+
+    {
+        HeapBlock<int> fill (numSlots);
+
+        for (int i = 0; i < numParameters; ++i)
+            fill[i] = firstEdge[i];
+
+        for (int i = 0; i < edges.size(); ++i)
+        {
+            const Edge& e = edges.getReference (i);
+            sortedEdges [fill [e.source]++] = i;
+
+            if (e.type == macroEdge)
+                isMeta [e.source] = 1;
+        }
+    }
+
+    // scratch space for update()
+    pendingNodes.malloc ((size_t) jmax (1, numNodes));
+    isNodePending.calloc ((size_t) jmax (1, numNodes));
+    memberQueue.malloc (numSlots);
+    changedParameters.malloc (numSlots);
+    isParameterDirty.calloc (numSlots);
+    isParameterChanged.calloc (numSlots);
+
+    isBuilt = true;
+    return isAcyclic;
+}
+
+//==============================================================================
+bool PluginParameterGraph::isMetaParameter (const int parameterIndex) const noexcept
+{
+    return isBuilt && isPositiveAndBelow (parameterIndex, numParameters) && isMeta [parameterIndex] != 0;
+}
+
+bool PluginParameterGraph::hasDependents (const int parameterIndex) const noexcept
+{
+    return isBuilt && isPositiveAndBelow (parameterIndex, numParameters)
+            && firstEdge [parameterIndex] != firstEdge [parameterIndex + 1];
+}
+
+//==============================================================================
+int PluginParameterGraph::update (const int changedIndex, OwnedArray<PluginParameter>& parameters,
+                                  Callback& callback) noexcept
+{
+    if (! hasDependents (changedIndex))
+        return 0;
+
+    // this graph was set up for more parameters than you've given it
+    jassert (parameters.size() >= numParameters);
+
+    if (parameters.size() < numParameters)
+        return 0;
+
+    const SpinLock::ScopedLockType sl (updateLock);
+
+    int numChanged = 0, numPending = 0;
+
+    isParameterDirty [changedIndex] = 1;
+    addPendingNode (nodeForParameter [changedIndex], numPending);
+
+    while (numPending > 0)
+    {
+        const int node = pendingNodes [--numPending];
+        isNodePending [node] = 0;
+
+        // start from the members that have been set, and spread their values
+        // to the rest of the node through its links and constraints
+        int queueStart = 0, queueEnd = 0;
+
+        for (int i = firstMember [node]; i < firstMember [node + 1]; ++i)
+            if (isParameterDirty [members[i]] != 0)
+                memberQueue [queueEnd++] = members[i];
+
+        while (queueStart < queueEnd)
+        {
+            const int p = memberQueue [queueStart++];
+
+            for (int i = firstEdge[p]; i < firstEdge[p + 1]; ++i)
+            {
+                const Edge& e = edges.getReference (sortedEdges[i]);
+
+                if (e.type != macroEdge && isParameterDirty [e.target] == 0 && applyEdge (e, parameters))
+                {
+                    isParameterDirty [e.target] = 1;
+                    memberQueue [queueEnd++] = e.target;
+                }
+            }
+        }
+
+        // then pass them on to any macro targets, which are always in later nodes
+        for (int q = 0; q < queueEnd; ++q)
+        {
+            const int p = memberQueue[q];
+
+            if (p != changedIndex && isParameterChanged[p] == 0)
+            {
+                isParameterChanged[p] = 1;
+                changedParameters [numChanged++] = p;
+            }
+
+            for (int i = firstEdge[p]; i < firstEdge[p + 1]; ++i)
+            {
+                const Edge& e = edges.getReference (sortedEdges[i]);
+
+                if (e.type == macroEdge && applyEdge (e, parameters))
+                {
+                    isParameterDirty [e.target] = 1;
+                    addPendingNode (nodeForParameter [e.target], numPending);
+                }
+            }
+        }
+    }
+
+    isParameterDirty [changedIndex] = 0;
+
+    // these are scratch space shared by every update, so they're passed on
+    // before the lock is released
+    for (int i = 0; i < numChanged; ++i)
+    {
+        isParameterDirty [changedParameters[i]] = 0;
+        isParameterChanged [changedParameters[i]] = 0;
+        callback.dependentParameterChanged (changedParameters[i]);
+    }
+
+    return numChanged;
+}
+
+bool PluginParameterGraph::applyEdge (const Edge& e, OwnedArray<PluginParameter>& parameters) noexcept
+{
+    PluginParameter* const source = parameters.getUnchecked (e.source);
+    PluginParameter* const target = parameters.getUnchecked (e.target);
+    const double oldValue = target->getValue();
+
+    switch (e.type)
+    {
+        case macroEdge:
+            target->setNormalisedValue (jlimit (0.0, 1.0, e.offset + e.amount * source->getNormalisedValue()));
+            break;
+
+        case linkEdge:
+            target->setNormalisedValue (source->getNormalisedValue());
+            break;
+
+        case keepAboveEdge:
+            if (oldValue < source->getValue())
+                target->setValue (source->getValue());
+            break;
+
+        case keepBelowEdge:
+            if (oldValue > source->getValue())
+                target->setValue (source->getValue());
+            break;
+
+        default:
+            break;
+    }
+
+    return target->getValue() != oldValue;
+}
+
+void PluginParameterGraph::addPendingNode (const int node, int& numPending) noexcept
+{
+    if (isNodePending [node] != 0)
+        return;
+
+    isNodePending [node] = 1;
+
+    // keep the pending nodes sorted with the lowest rank at the end
+    int i = numPending++;
+
+    while (i > 0 && nodeRank [pendingNodes [i - 1]] < nodeRank [node])
+    {
+        pendingNodes[i] = pendingNodes[i - 1];
+        --i;
+    }
+
+    pendingNodes[i] = node;
+}
+
+//END_JUCE_NAMESPACE
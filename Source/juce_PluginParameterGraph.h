@@ -0,0 +1,173 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERGRAPH_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERGRAPH_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameter.h"
+
+//==============================================================================
+/**
+    Describes how some parameters depend on others, and keeps them up to date
+    when one of them changes.
+
+    There are three kinds of dependency:
+    - a macro sets one or more target parameters from its own value, which
+      makes it a meta parameter,
+    - a link keeps two parameters at the same position, e.g. the left and
+      right sides of a stereo pair, whichever one is moved,
+    - a min/max constraint keeps one parameter's value at or below another's,
+      pushing the other one along if either is moved past it.
+
+    Links and constraints work both ways, so the parameters they join are
+    treated as a single node. Macros must only go one way between these nodes,
+    and build() sorts the nodes so that every macro comes before its targets.
+
+    When a parameter changes, update() only visits the nodes that can be
+    reached from it, in sorted order, so each affected parameter is worked out
+    once from its final inputs. It passes the parameters whose values actually
+    changed, each one once, to a Callback.
+
+    @code
+    // in the constructor
+    graph.setNumParameters (totalNumParams);
+    graph.addMacro (brightness, filterCutoff);
+    graph.addMacro (brightness, filterResonance, 0.5f);
+    graph.addLink (gainLeft, gainRight);
+    graph.addMinMaxConstraint (rangeLow, rangeHigh);
+    graph.build();
+
+    // in setParameter(), where this is a PluginParameterGraph::Callback
+    graph.update (index, parameters, *this);
+
+    void dependentParameterChanged (int index)
+    {
+        // flag it, and tell the host later from the message thread
+    }
+    @endcode
+ */
+class PluginParameterGraph
+{
+public:
+    //==============================================================================
+    /** Creates an empty graph. */
+    PluginParameterGraph();
+
+    /** Destructor. */
+    ~PluginParameterGraph();
+
+    //==============================================================================
+    /** Removes all the dependencies and sets the number of parameters. */
+    void setNumParameters (int numParameters);
+
+    /** Makes a macro set a target parameter whenever it changes.
+        The target's normalised value is set to offset + amount * the macro's
+        normalised value, clipped to 0 - 1. If a target has more than one macro
+        the one that changed last wins.
+     */
+    void addMacro (int macroIndex, int targetIndex, float amount = 1.0f, float offset = 0.0f);
+
+    /** Keeps two parameters at the same normalised value. */
+    void addLink (int firstIndex, int secondIndex);
+
+    /** Keeps the value of one parameter at or below the value of another. */
+    void addMinMaxConstraint (int minIndex, int maxIndex);
+
+    /** Sorts the dependencies and allocates everything update() needs.
+        Call this once all the dependencies have been added. This returns false,
+        and leaves out the macros causing it, if the macros form a loop.
+     */
+    bool build();
+
+    //==============================================================================
+    /** Returns true if a parameter is a macro for any other parameters. */
+    bool isMetaParameter (int parameterIndex) const noexcept;
+
+    /** Returns true if changing a parameter can change any others. */
+    bool hasDependents (int parameterIndex) const noexcept;
+
+    //==============================================================================
+    /** Receives the parameters that an update() has changed. */
+    class Callback
+    {
+    public:
+        virtual ~Callback() {}
+
+        /** Called once for each other parameter whose value was changed.
+
+            This is called while update() holds its lock, so it mustn't block or
+            call update() itself. It can be called on the audio thread, so don't
+            call into the host from here.
+         */
+        virtual void dependentParameterChanged (int parameterIndex) = 0;
+    };
+
+    /** Updates all the parameters that depend on one that has just changed.
+
+        Each other parameter whose value changed is passed to the callback, and
+        the number of them is returned. This doesn't allocate, and can be called
+        from several threads. Only one update happens at a time, and its changes
+        are all passed on before the next one starts, so they can't get mixed up.
+     */
+    int update (int changedIndex, OwnedArray<PluginParameter>& parameters, Callback& callback) noexcept;
+
+private:
+    //==============================================================================
+    enum EdgeType
+    {
+        macroEdge,
+        linkEdge,
+        keepAboveEdge,
+        keepBelowEdge
+    };
+
+    struct Edge
+    {
+        int source, target, type;
+        float amount, offset;
+    };
+
+    int numParameters, numNodes;
+    Array<Edge> edges;
+    bool isBuilt;
+
+    // everything below is set up by build()
+    HeapBlock<int> nodeForParameter, nodeRank, firstMember, members;
+    HeapBlock<int> firstEdge, sortedEdges;
+    HeapBlock<uint8> isMeta;
+
+    HeapBlock<int> pendingNodes, memberQueue, changedParameters;
+    HeapBlock<uint8> isNodePending, isParameterDirty, isParameterChanged;
+    SpinLock updateLock;
+
+    bool applyEdge (const Edge& edge, OwnedArray<PluginParameter>& parameters) noexcept;
+    void addPendingNode (int node, int& numPending) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterGraph);
+};
+
+#endif //__JUCE_PLUGINPARAMETERGRAPH_JUCEHEADER__
@@ -0,0 +1,218 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterGroup.h"
+
+PluginParameterGroup::PluginParameterGroup (const String& name_, const int firstIndex_, const int numParameters_)
+    : name (name_),
+      firstIndex (firstIndex_),
+      numParameters (jmax (0, numParameters_)),
+      parent (nullptr),
+      changed (0)
+{
+    // the top-level group keeps a table of the smallest group each parameter
+    // is in, so parameterChanged() doesn't have to search for it
+    groupForParameter.malloc ((size_t) jmax (1, numParameters));
+
+    for (int i = 0; i < numParameters; ++i)
+        groupForParameter[i] = this;
+}
+
+PluginParameterGroup::PluginParameterGroup (PluginParameterGroup* parent_, const String& name_,
+                                            const int firstIndex_, const int numParameters_)
+    : name (name_),
+      firstIndex (firstIndex_),
+      numParameters (jmax (0, numParameters_)),
+      parent (parent_),
+      changed (0)
+{
+}
+
+PluginParameterGroup::~PluginParameterGroup()
+{
+}
+
+//==============================================================================
+PluginParameterGroup* PluginParameterGroup::addSubGroup (const String& subGroupName,
+                                                         const int subGroupFirstIndex,
+                                                         const int subGroupNumParameters)
+{
+    // sub-groups have to fit inside their parent..
+    jassert (subGroupNumParameters >= 0
+              && subGroupFirstIndex >= firstIndex
+              && subGroupFirstIndex + subGroupNumParameters <= firstIndex + numParameters);
+
+   #if JUCE_DEBUG
+    // ..and mustn't overlap each other
+    for (int i = 0; i < subGroups.size(); ++i)
+    {
+        const PluginParameterGroup* const other = subGroups.getUnchecked (i);
+
+        jassert (subGroupFirstIndex + subGroupNumParameters <= other->firstIndex
+                  || subGroupFirstIndex >= other->firstIndex + other->numParameters);
+    }
+   #endif
+
+    const int start = jmax (firstIndex, subGroupFirstIndex);
+    const int end = jmin (firstIndex + numParameters, subGroupFirstIndex + jmax (0, subGroupNumParameters));
+
+    PluginParameterGroup* const newGroup = subGroups.add (new PluginParameterGroup (this, subGroupName,
+                                                                                    start, jmax (0, end - start)));
+
+    PluginParameterGroup* const topLevel = getTopLevelGroup();
+
+    for (int i = start; i < end; ++i)
+        topLevel->groupForParameter [i - topLevel->firstIndex] = newGroup;
+
+    return newGroup;
+}
+
+const String PluginParameterGroup::getPath() const
+{
+    if (parent == nullptr)
+        return String::empty;
+
+    const String parentPath (parent->getPath());
+
+    return parentPath.isEmpty() ? name
+                                : parentPath + "/" + name;
+}
+
+PluginParameterGroup* PluginParameterGroup::getTopLevelGroup() noexcept
+{
+    PluginParameterGroup* g = this;
+
+    while (g->parent != nullptr)
+        g = g->parent;
+
+    return g;
+}
+
+//==============================================================================
+PluginParameterGroup* PluginParameterGroup::findGroup (const String& path) const
+{
+    const String firstPart (path.upToFirstOccurrenceOf ("/", false, false));
+    const String rest (path.fromFirstOccurrenceOf ("/", false, false));
+
+    for (int i = 0; i < subGroups.size(); ++i)
+    {
+        PluginParameterGroup* const g = subGroups.getUnchecked (i);
+
+        if (g->name == firstPart)
+            return rest.isEmpty() ? g : g->findGroup (rest);
+    }
+
+    return nullptr;
+}
+
+int PluginParameterGroup::findParameter (const String& path, const OwnedArray<PluginParameter>& parameters) const
+{
+    const PluginParameterGroup* group = this;
+
+    if (path.containsChar ('/'))
+    {
+        group = findGroup (path.upToLastOccurrenceOf ("/", false, false));
+
+        if (group == nullptr)
+            return -1;
+    }
+
+    const String identifier (path.fromLastOccurrenceOf ("/", false, false));
+    const int end = jmin (group->firstIndex + group->numParameters, parameters.size());
+
+    for (int i = jmax (0, group->firstIndex); i < end; ++i)
+        if (parameters.getUnchecked (i)->getIdentifier() == identifier)
+            return i;
+
+    return -1;
+}
+
+PluginParameterGroup* PluginParameterGroup::getGroupForParameter (const int parameterIndex) const noexcept
+{
+    if (! containsParameter (parameterIndex))
+        return nullptr;
+
+    if (parent == nullptr)
+        return groupForParameter [parameterIndex - firstIndex];
+
+    for (int i = 0; i < subGroups.size(); ++i)
+    {
+        PluginParameterGroup* const g = subGroups.getUnchecked (i);
+
+        if (g->containsParameter (parameterIndex))
+            return g->getGroupForParameter (parameterIndex);
+    }
+
+    return const_cast <PluginParameterGroup*> (this);
+}
+
+//==============================================================================
+void PluginParameterGroup::resetToDefaults (OwnedArray<PluginParameter>& parameters)
+{
+    const int end = jmin (firstIndex + numParameters, parameters.size());
+
+    for (int i = jmax (0, firstIndex); i < end; ++i)
+    {
+        PluginParameter* const parameter = parameters.getUnchecked (i);
+        parameter->setValue (parameter->getDefault());
+    }
+
+    markChanged();
+}
+
+bool PluginParameterGroup::copyValuesFrom (const PluginParameterGroup& source, OwnedArray<PluginParameter>& parameters)
+{
+    if (source.numParameters != numParameters
+         || jmax (firstIndex, source.firstIndex) + numParameters > parameters.size()
+         || jmin (firstIndex, source.firstIndex) < 0)
+        return false;
+
+    if (&source == this)
+        return true;
+
+    for (int i = 0; i < numParameters; ++i)
+        parameters.getUnchecked (firstIndex + i)->copyValueFrom (*parameters.getUnchecked (source.firstIndex + i));
+
+    markChanged();
+    return true;
+}
+
+//==============================================================================
+void PluginParameterGroup::parameterChanged (const int parameterIndex) noexcept
+{
+    PluginParameterGroup* const g = getGroupForParameter (parameterIndex);
+
+    if (g != nullptr)
+        g->markChanged();
+}
+
+void PluginParameterGroup::markChanged() noexcept
+{
+    for (PluginParameterGroup* g = this; g != nullptr; g = g->parent)
+        g->changed = 1;
+}
+
+//END_JUCE_NAMESPACE
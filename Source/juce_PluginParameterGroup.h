@@ -0,0 +1,175 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERGROUP_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERGROUP_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "juce_PluginParameter.h"
+
+//==============================================================================
+/**
+    A named, contiguous range of parameters, such as an EQ band, a voice or a
+    module, which can contain smaller groups of its own.
+
+    Groups don't own their parameters, they just refer to a range of indexes in
+    the processor's parameter array, so all the members of a group are stored
+    next to each other and can be handled in one go: reset to their defaults,
+    or copied from another group with the same layout.
+
+    Each group also has a change flag. Call parameterChanged() on the top-level
+    group whenever a parameter is set, and it'll flag the group that parameter
+    is in along with all the groups above it. A DSP module can then check its
+    one flag each block rather than looking at each of its parameters.
+
+    Groups can be found by a path of names separated by slashes, e.g.
+    "eq/band1", and parameters by adding their identifier, e.g. "eq/band1/gain".
+
+    @code
+    PluginParameterGroup root ("", 0, totalNumParams);
+    PluginParameterGroup* eq = root.addSubGroup ("eq", eqStart, numBands * 3);
+
+    for (int i = 0; i < numBands; ++i)
+        eq->addSubGroup ("band" + String (i + 1), eqStart + i * 3, 3);
+
+    // in setParameter()
+    root.parameterChanged (index);
+
+    // in processBlock()
+    if (eq->checkAndClearChanged())
+        updateFilters();
+    @endcode
+ */
+class PluginParameterGroup
+{
+public:
+    //==============================================================================
+    /** Creates a top-level group covering a range of parameters. */
+    PluginParameterGroup (const String& name, int firstIndex, int numParameters);
+
+    /** Destructor. */
+    ~PluginParameterGroup();
+
+    //==============================================================================
+    /** Adds a group within this one and returns it.
+        The range must lie inside this group's range and mustn't overlap any other
+        sub-group. The new group is owned by this one.
+     */
+    PluginParameterGroup* addSubGroup (const String& name, int firstIndex, int numParameters);
+
+    /** Returns the number of groups directly inside this one. */
+    int getNumSubGroups() const noexcept                    { return subGroups.size(); }
+
+    /** Returns one of the groups directly inside this one. */
+    PluginParameterGroup* getSubGroup (int index) const noexcept    { return subGroups[index]; }
+
+    /** Returns the group this one is in, or nullptr if it's a top-level group. */
+    PluginParameterGroup* getParentGroup() const noexcept   { return parent; }
+
+    //==============================================================================
+    const String& getName() const noexcept                  { return name; }
+
+    /** Returns the names of this group and the groups above it, separated by
+        slashes, not including the top-level group.
+     */
+    const String getPath() const;
+
+    int getFirstIndex() const noexcept                      { return firstIndex; }
+    int getNumParameters() const noexcept                   { return numParameters; }
+
+    bool containsParameter (int parameterIndex) const noexcept
+    {
+        return isPositiveAndBelow (parameterIndex - firstIndex, numParameters);
+    }
+
+    //==============================================================================
+    /** Finds a group from a path relative to this one, e.g. "eq/band1".
+        Returns nullptr if there isn't one.
+     */
+    PluginParameterGroup* findGroup (const String& path) const;
+
+    /** Finds a parameter from a path relative to this group, e.g. "band1/gain",
+        where the last part is the parameter's identifier. Returns -1 if there
+        isn't one.
+     */
+    int findParameter (const String& path, const OwnedArray<PluginParameter>& parameters) const;
+
+    /** Returns the smallest group containing a parameter, or nullptr if it isn't
+        in this group.
+     */
+    PluginParameterGroup* getGroupForParameter (int parameterIndex) const noexcept;
+
+    //==============================================================================
+    /** Sets all the parameters in this group back to their defaults.
+
+        This only sets the values and the group's change flag. The processor and
+        the host aren't told, so call AudioProcessorExt::parameterValueChanged()
+        and AudioProcessor::sendParamChangeMessageToListeners() for each of the
+        group's parameters afterwards.
+     */
+    void resetToDefaults (OwnedArray<PluginParameter>& parameters);
+
+    /** Copies the values of another group's parameters into this group's, e.g.
+        to copy one EQ band to another. The groups must be the same size, and
+        this returns false if they aren't.
+
+        As with resetToDefaults(), the caller has to tell the processor and the
+        host about the new values.
+     */
+    bool copyValuesFrom (const PluginParameterGroup& source, OwnedArray<PluginParameter>& parameters);
+
+    //==============================================================================
+    /** Flags the group containing a parameter, and all the groups above it, as
+        changed. This is safe to call from any thread.
+     */
+    void parameterChanged (int parameterIndex) noexcept;
+
+    /** Flags this group and all the groups above it as changed. */
+    void markChanged() noexcept;
+
+    /** Returns true if any of this group's parameters have changed since the
+        flag was last cleared.
+     */
+    bool hasChanged() const noexcept                        { return changed.get() != 0; }
+
+    /** Clears the change flag, returning true if it was set. */
+    bool checkAndClearChanged() noexcept                    { return changed.compareAndSetBool (0, 1); }
+
+private:
+    //==============================================================================
+    String name;
+    int firstIndex, numParameters;
+    PluginParameterGroup* parent;
+    OwnedArray<PluginParameterGroup> subGroups;
+    HeapBlock<PluginParameterGroup*> groupForParameter;
+    Atomic<int> changed;
+
+    PluginParameterGroup (PluginParameterGroup* parent, const String& name, int firstIndex, int numParameters);
+    PluginParameterGroup* getTopLevelGroup() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterGroup);
+};
+
+#endif //__JUCE_PLUGINPARAMETERGROUP_JUCEHEADER__
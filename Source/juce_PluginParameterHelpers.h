@@ -72,6 +72,17 @@ namespace {
         else
             return false;
     }    
+
+    /** Returns true if a unit controls a level, where jumping straight to a new
+        value would be heard as a click.
+     */
+    inline bool isGainUnit (ParameterUnit unit)
+    {
+        return unit == UnitDecibels
+            || unit == UnitLinearGain
+            || unit == UnitEqualPowerCrossfade
+            || unit == UnitMixerFaderCurve1;
+    }
 }
 
 #endif //__JUCE_PLUGINPARAMETERHELPERS_JUCEHEADER__
\ No newline at end of file
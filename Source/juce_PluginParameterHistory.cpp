@@ -0,0 +1,168 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterHistory.h"
+
+PluginParameterHistory::PluginParameterHistory (int numParameters_, int maxNumChanges)
+    : numParameters (jmax (0, numParameters_)),
+      capacity (jmax (1, maxNumChanges)),
+      oldest (0),
+      numStored (0),
+      numUndoable (0),
+      numOpenGestures (0),
+      currentTransaction (0)
+{
+    deltas.malloc ((size_t) capacity);
+    gestureStartValues.calloc ((size_t) jmax (1, numParameters));
+    gestureOpen.calloc ((size_t) jmax (1, numParameters));
+}
+
+PluginParameterHistory::~PluginParameterHistory()
+{
+}
+
+//==============================================================================
+void PluginParameterHistory::gestureStarted (int parameterIndex, double currentValue)
+{
+    if (isPositiveAndBelow (parameterIndex, numParameters) && ! gestureOpen [parameterIndex])
+    {
+        // overlapping gestures, e.g. both axes of an XY pad, end up in one transaction
+        if (numOpenGestures++ == 0)
+            startTransaction();
+
+        gestureOpen [parameterIndex] = true;
+        gestureStartValues [parameterIndex] = currentValue;
+    }
+}
+
+void PluginParameterHistory::gestureEnded (int parameterIndex, double currentValue)
+{
+    if (isPositiveAndBelow (parameterIndex, numParameters) && gestureOpen [parameterIndex])
+    {
+        gestureOpen [parameterIndex] = false;
+        --numOpenGestures;
+
+        if (gestureStartValues [parameterIndex] != currentValue)
+            addDelta (parameterIndex, gestureStartValues [parameterIndex], currentValue);
+    }
+}
+
+void PluginParameterHistory::valueChanged (int parameterIndex, double oldValue, double newValue)
+{
+    if (isPositiveAndBelow (parameterIndex, numParameters)
+         && ! gestureOpen [parameterIndex]
+         && oldValue != newValue)
+    {
+        if (numOpenGestures == 0)
+            startTransaction();
+
+        addDelta (parameterIndex, oldValue, newValue);
+    }
+}
+
+//==============================================================================
+bool PluginParameterHistory::canUndo() const noexcept
+{
+    return numUndoable > 0 && numOpenGestures == 0;
+}
+
+bool PluginParameterHistory::canRedo() const noexcept
+{
+    return numUndoable < numStored && numOpenGestures == 0;
+}
+
+bool PluginParameterHistory::undo (Target& target)
+{
+    if (! canUndo())
+        return false;
+
+    const uint32 transaction = getDelta (numUndoable - 1).transaction;
+
+    while (numUndoable > 0 && getDelta (numUndoable - 1).transaction == transaction)
+    {
+        const Delta& delta = getDelta (--numUndoable);
+        target.applyHistoryValue (delta.parameterIndex, delta.oldValue);
+    }
+
+    return true;
+}
+
+bool PluginParameterHistory::redo (Target& target)
+{
+    if (! canRedo())
+        return false;
+
+    const uint32 transaction = getDelta (numUndoable).transaction;
+
+    while (numUndoable < numStored && getDelta (numUndoable).transaction == transaction)
+    {
+        const Delta& delta = getDelta (numUndoable++);
+        target.applyHistoryValue (delta.parameterIndex, delta.newValue);
+    }
+
+    return true;
+}
+
+void PluginParameterHistory::clear() noexcept
+{
+    oldest = numStored = numUndoable = 0;
+}
+
+//==============================================================================
+void PluginParameterHistory::startTransaction() noexcept
+{
+    ++currentTransaction;
+}
+
+void PluginParameterHistory::addDelta (int parameterIndex, double oldValue, double newValue) noexcept
+{
+    // a new change throws away anything that was undone
+    numStored = numUndoable;
+
+    if (numStored == capacity)
+    {
+        // make room by dropping the oldest transaction, unless this one fills the whole buffer
+        const uint32 transactionToDrop = getDelta (0).transaction;
+        const bool isOnlyTransaction = (transactionToDrop == currentTransaction);
+
+        do
+        {
+            oldest = (oldest + 1) % capacity;
+            --numStored;
+        }
+        while (! isOnlyTransaction && numStored > 0 && getDelta (0).transaction == transactionToDrop);
+    }
+
+    Delta& delta = getDelta (numStored++);
+    delta.parameterIndex = parameterIndex;
+    delta.transaction = currentTransaction;
+    delta.oldValue = oldValue;
+    delta.newValue = newValue;
+
+    numUndoable = numStored;
+}
+
+//END_JUCE_NAMESPACE
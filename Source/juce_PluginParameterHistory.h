@@ -0,0 +1,126 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERHISTORY_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERHISTORY_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    An undo/redo history of parameter changes.
+
+    Rather than storing whole states, each change is stored as a small delta of
+    (index, old value, new value) in a ring buffer that's allocated up front.
+    Deltas are grouped into transactions: everything recorded while one or more
+    change gestures are open is undone and redone together. When the buffer is
+    full the oldest transactions are dropped, so memory use stays the same
+    however long the session runs.
+
+    This doesn't know anything about the parameters themselves; undo() and redo()
+    pass the values to apply to a Target.
+
+    @see AudioProcessorExt::setUndoHistorySize
+ */
+class PluginParameterHistory
+{
+public:
+    //==============================================================================
+    /** Creates a history for a number of parameters, which can hold up to
+        maxNumChanges individual parameter changes.
+     */
+    PluginParameterHistory (int numParameters, int maxNumChanges);
+
+    /** Destructor. */
+    ~PluginParameterHistory();
+
+    //==============================================================================
+    /** Receives the values to set when undoing or redoing. */
+    class Target
+    {
+    public:
+        virtual ~Target() {}
+
+        /** Called for each parameter that needs to change. */
+        virtual void applyHistoryValue (int parameterIndex, double newValue) = 0;
+    };
+
+    //==============================================================================
+    /** Call this when a change gesture begins, with the parameter's value before
+        it's changed.
+     */
+    void gestureStarted (int parameterIndex, double currentValue);
+
+    /** Call this when a change gesture ends, with the parameter's final value. */
+    void gestureEnded (int parameterIndex, double currentValue);
+
+    /** Records a single change that happened outside a gesture.
+        Changes to a parameter that's in the middle of a gesture are ignored, as
+        the gesture will record them when it ends.
+     */
+    void valueChanged (int parameterIndex, double oldValue, double newValue);
+
+    /** Returns true if any gestures are currently open. */
+    bool isInGesture() const noexcept                           { return numOpenGestures > 0; }
+
+    //==============================================================================
+    bool canUndo() const noexcept;
+    bool canRedo() const noexcept;
+
+    /** Undoes the last transaction, passing its old values to the target.
+        Returns false if there was nothing to undo or a gesture is still open.
+     */
+    bool undo (Target& target);
+
+    /** Redoes the last undone transaction, passing its new values to the target. */
+    bool redo (Target& target);
+
+    /** Removes everything from the history. */
+    void clear() noexcept;
+
+private:
+    //==============================================================================
+    struct Delta
+    {
+        int parameterIndex;
+        uint32 transaction;
+        double oldValue, newValue;
+    };
+
+    HeapBlock<Delta> deltas;
+    HeapBlock<double> gestureStartValues;
+    HeapBlock<bool> gestureOpen;
+    int numParameters, capacity;
+    int oldest, numStored, numUndoable, numOpenGestures;
+    uint32 currentTransaction;
+
+    Delta& getDelta (int position) const noexcept               { return deltas [(oldest + position) % capacity]; }
+    void startTransaction() noexcept;
+    void addDelta (int parameterIndex, double oldValue, double newValue) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterHistory);
+};
+
+#endif //__JUCE_PLUGINPARAMETERHISTORY_JUCEHEADER__
@@ -0,0 +1,156 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterIndex.h"
+#include "juce_PluginParameter.h"
+
+PluginParameterIndex::PluginParameterIndex()
+    : numSlots (0),
+      numParameters (0)
+{
+}
+
+PluginParameterIndex::~PluginParameterIndex()
+{
+}
+
+void PluginParameterIndex::reset (const int expectedNumParameters)
+{
+    int newNumSlots = 8;
+
+    while (newNumSlots < expectedNumParameters * 2)
+        newNumSlots <<= 1;
+
+    if (numSlots != newNumSlots)
+    {
+        numSlots = newNumSlots;
+        hashes.malloc ((size_t) numSlots);
+        indexes.malloc ((size_t) numSlots);
+    }
+
+    identifiers.clear();
+    identifiers.ensureStorageAllocated (numSlots);
+
+    for (int i = 0; i < numSlots; ++i)
+    {
+        indexes[i] = -1;
+        identifiers.add (String::empty);
+    }
+
+    numParameters = 0;
+}
+
+void PluginParameterIndex::add (const String& identifier, const int parameterIndex)
+{
+    // call reset() with enough room first!
+    jassert (numParameters < numSlots / 2);
+
+    if (numParameters >= numSlots / 2)
+        return;
+
+    const uint32 identifierHash = hashIdentifier (identifier);
+    int slot = (int) (identifierHash & (uint32) (numSlots - 1));
+
+    while (indexes[slot] >= 0)
+    {
+        // two of your parameters have identifiers with the same hash, so one of
+        // them can't be found when state is loaded. Give one a different identifier.
+        jassert (hashes[slot] != identifierHash);
+
+        if (hashes[slot] == identifierHash)
+            return;
+
+        slot = (slot + 1) & (numSlots - 1);
+    }
+
+    hashes[slot] = identifierHash;
+    indexes[slot] = parameterIndex;
+    identifiers.set (slot, identifier);
+    ++numParameters;
+}
+
+void PluginParameterIndex::build (const OwnedArray<PluginParameter>& parameters)
+{
+    reset (parameters.size());
+
+    for (int i = 0; i < parameters.size(); ++i)
+        add (parameters.getUnchecked (i)->getIdentifier(), i);
+}
+
+//==============================================================================
+int PluginParameterIndex::findSlot (const uint32 identifierHash) const noexcept
+{
+    if (numSlots == 0)
+        return -1;
+
+    int slot = (int) (identifierHash & (uint32) (numSlots - 1));
+
+    while (indexes[slot] >= 0)
+    {
+        if (hashes[slot] == identifierHash)
+            return slot;
+
+        slot = (slot + 1) & (numSlots - 1);
+    }
+
+    return -1;
+}
+
+int PluginParameterIndex::getIndexForHash (const uint32 identifierHash) const noexcept
+{
+    const int slot = findSlot (identifierHash);
+    return slot >= 0 ? indexes[slot] : -1;
+}
+
+int PluginParameterIndex::getIndexForIdentifier (const String& identifier) const noexcept
+{
+    const int slot = findSlot (hashIdentifier (identifier));
+
+    // a different identifier can have the same hash, so make sure it's this one
+    if (slot < 0 || identifiers[slot] != identifier)
+        return -1;
+
+    return indexes[slot];
+}
+
+uint32 PluginParameterIndex::hashIdentifier (const String& identifier) noexcept
+{
+    const char* t = identifier.toUTF8();
+    uint32 hash = 2166136261u;
+
+    if (t != nullptr)
+    {
+        while (*t != 0)
+        {
+            hash ^= (uint32) (uint8) *t++;
+            hash *= 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,108 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERINDEX_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERINDEX_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class PluginParameter;
+
+//==============================================================================
+/**
+    Maps parameter identifiers to their index in a processor.
+
+    Each identifier is reduced to a 32-bit hash, and the hashes are kept in an
+    open-addressed table at least twice the size of the parameter set, so looking
+    up a parameter while loading state takes constant time rather than a search
+    through every parameter.
+
+    The identifiers themselves are kept too, so looking one up by name checks
+    that it really is the parameter that was found, not just one whose hash
+    is the same.
+
+    The table is built once, when the parameters are set up, and only read after
+    that, so it's safe to read from several threads at once.
+
+    @see PluginParameter::setIdentifier
+ */
+class PluginParameterIndex
+{
+public:
+    //==============================================================================
+    /** Creates an empty index. */
+    PluginParameterIndex();
+
+    /** Destructor. */
+    ~PluginParameterIndex();
+
+    //==============================================================================
+    /** Empties the index and makes room for a number of parameters. */
+    void reset (int numParameters);
+
+    /** Adds a parameter's identifier to the index.
+
+        If two identifiers have the same hash the first one wins. This will assert
+        if that happens, in which case you should rename one of them.
+     */
+    void add (const String& identifier, int parameterIndex);
+
+    /** Resets the index and adds all of some parameters. */
+    void build (const OwnedArray<PluginParameter>& parameters);
+
+    /** Returns the number of parameters in the index. */
+    int getNumParameters() const noexcept                   { return numParameters; }
+
+    //==============================================================================
+    /** Returns the index of the parameter with an identifier hash, or -1.
+        Saved state only has the hashes, so this can't tell two identifiers with
+        the same hash apart; add() asserts if any of the parameters' do.
+     */
+    int getIndexForHash (uint32 identifierHash) const noexcept;
+
+    /** Returns the index of the parameter with an identifier, or -1 if there
+        isn't one, including when another parameter's identifier has the same hash.
+     */
+    int getIndexForIdentifier (const String& identifier) const noexcept;
+
+    /** Returns the hash used for an identifier.
+        This is a 32-bit FNV-1a hash of its UTF-8 bytes, so it's the same on every
+        platform and can be stored.
+     */
+    static uint32 hashIdentifier (const String& identifier) noexcept;
+
+private:
+    //==============================================================================
+    HeapBlock<uint32> hashes;
+    HeapBlock<int> indexes;
+    StringArray identifiers;
+    int numSlots, numParameters;
+
+    int findSlot (uint32 identifierHash) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginParameterIndex);
+};
+
+#endif //__JUCE_PLUGINPARAMETERINDEX_JUCEHEADER__
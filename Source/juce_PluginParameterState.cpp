@@ -0,0 +1,266 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterState.h"
+
+namespace PluginParameterStateHelpers
+{
+    inline void writeUInt16 (char* dest, uint16 value) noexcept
+    {
+        value = ByteOrder::swapIfBigEndian (value);
+        memcpy (dest, &value, sizeof (value));
+    }
+
+    inline void writeUInt32 (char* dest, uint32 value) noexcept
+    {
+        value = ByteOrder::swapIfBigEndian (value);
+        memcpy (dest, &value, sizeof (value));
+    }
+
+    inline void writeDouble (char* dest, double value) noexcept
+    {
+        uint64 bits;
+        memcpy (&bits, &value, sizeof (bits));
+        bits = ByteOrder::swapIfBigEndian (bits);
+        memcpy (dest, &bits, sizeof (bits));
+    }
+
+    inline uint16 readUInt16 (const char* src) noexcept
+    {
+        uint16 value;
+        memcpy (&value, src, sizeof (value));
+        return ByteOrder::swapIfBigEndian (value);
+    }
+
+    inline uint32 readUInt32 (const char* src) noexcept
+    {
+        uint32 value;
+        memcpy (&value, src, sizeof (value));
+        return ByteOrder::swapIfBigEndian (value);
+    }
+
+    inline double readDouble (const char* src) noexcept
+    {
+        uint64 bits;
+        memcpy (&bits, src, sizeof (bits));
+        bits = ByteOrder::swapIfBigEndian (bits);
+
+        double value;
+        memcpy (&value, &bits, sizeof (value));
+        return value;
+    }
+
+    //==============================================================================
+    struct ParameterTarget
+    {
+        ParameterTarget (OwnedArray<PluginParameter>& parameters_, const PluginParameterIndex& index_)
+            : parameters (parameters_), index (index_) {}
+
+        int size() const noexcept                       { return parameters.size(); }
+        void set (int i, double value)                  { parameters.getUnchecked (i)->setValue (value); }
+
+        OwnedArray<PluginParameter>& parameters;
+        const PluginParameterIndex& index;
+    };
+
+    struct FrameTarget
+    {
+        FrameTarget (PluginParameterFrame& frame_, const PluginParameterIndex& index_)
+            : frame (frame_), index (index_) {}
+
+        int size() const noexcept                       { return frame.getNumParameters(); }
+        void set (int i, double value) noexcept         { frame.setValue (i, value); }
+
+        PluginParameterFrame& frame;
+        const PluginParameterIndex& index;
+    };
+
+    void writeHeader (char* d, uint16 flags, uint32 numEntries) noexcept
+    {
+        writeUInt32 (d, (uint32) PluginParameterState::magicNumber);
+        writeUInt16 (d + 4, (uint16) PluginParameterState::currentVersion);
+        writeUInt16 (d + 6, flags);
+        writeUInt32 (d + 8, numEntries);
+    }
+
+    void writeEntries (char* d, const OwnedArray<PluginParameter>& parameters) noexcept
+    {
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            writeUInt32 (d, parameters.getUnchecked (i)->getIdentifierHash());
+            writeDouble (d + 4, parameters.getUnchecked (i)->getValue());
+            d += PluginParameterState::entrySize;
+        }
+    }
+
+    template <class TargetType>
+    void readEntryBlock (const char* d, uint32 numEntries, TargetType& target, const bool idsAreIndexes)
+    {
+        const int numTargets = target.size();
+
+        for (uint32 i = 0; i < numEntries; ++i)
+        {
+            const uint32 id = readUInt32 (d);
+            const double value = readDouble (d + 4);
+            d += PluginParameterState::entrySize;
+
+            // version 1 stored indexes, later versions store identifier hashes
+            const int targetIndex = idsAreIndexes ? (id < (uint32) numTargets ? (int) id : -1)
+                                                  : target.index.getIndexForHash (id);
+
+            // skip ids we don't know about and anything that isn't a real number
+            if (isPositiveAndBelow (targetIndex, numTargets) && value == value)
+                target.set (targetIndex, value);
+        }
+    }
+
+    template <class TargetType>
+    bool readEntries (const void* data, int sizeInBytes, TargetType& target)
+    {
+        if (! PluginParameterState::isBinaryState (data, sizeInBytes))
+            return false;
+
+        const char* d = static_cast<const char*> (data);
+        const bool idsAreIndexes = readUInt16 (d + 4) < 2;
+        const uint16 flags = readUInt16 (d + 6);
+        const uint32 numEntries = readUInt32 (d + 8);
+        const int payloadSize = sizeInBytes - PluginParameterState::headerSize;
+        d += PluginParameterState::headerSize;
+
+        if ((flags & PluginParameterState::compressedFlag) == 0)
+        {
+            // only read as many entries as are actually there
+            const uint32 numAvailable = (uint32) payloadSize / (uint32) PluginParameterState::entrySize;
+            jassert (numEntries <= numAvailable); // this data has been truncated!
+
+            readEntryBlock (d, jmin (numEntries, numAvailable), target, idsAreIndexes);
+        }
+        else
+        {
+            // decompress a few entries at a time, so a corrupt header can't make
+            // us allocate a huge buffer and the whole state never needs copying
+            MemoryInputStream compressedStream (d, (size_t) payloadSize, false);
+            GZIPDecompressorInputStream decompressor (&compressedStream, false);
+
+            const uint32 entriesPerChunk = 256;
+            char buffer [entriesPerChunk * PluginParameterState::entrySize];
+            uint32 numLeft = numEntries;
+
+            while (numLeft > 0)
+            {
+                const int numBytesWanted = (int) (jmin (numLeft, entriesPerChunk) * (uint32) PluginParameterState::entrySize);
+                const int numBytesRead = decompressor.read (buffer, numBytesWanted);
+                const uint32 numRead = (uint32) jmax (0, numBytesRead) / (uint32) PluginParameterState::entrySize;
+
+                readEntryBlock (buffer, numRead, target, idsAreIndexes);
+
+                if (numBytesRead < numBytesWanted)
+                {
+                    jassertfalse; // this data has been truncated!
+                    break;
+                }
+
+                numLeft -= numRead;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+bool PluginParameterState::isBinaryState (const void* data, int sizeInBytes) noexcept
+{
+    using namespace PluginParameterStateHelpers;
+
+    const char* const d = static_cast<const char*> (data);
+
+    return data != nullptr
+            && sizeInBytes >= (int) headerSize
+            && readUInt32 (d) == (uint32) magicNumber
+            && readUInt16 (d + 4) <= (uint16) currentVersion
+            && (readUInt16 (d + 6) & ~(uint16) knownFlags) == 0;
+}
+
+size_t PluginParameterState::getSizeNeeded (int numParameters) noexcept
+{
+    return (size_t) headerSize + (size_t) jmax (0, numParameters) * (size_t) entrySize;
+}
+
+void PluginParameterState::write (const OwnedArray<PluginParameter>& parameters, juce::MemoryBlock& destData,
+                                  const bool shouldCompress)
+{
+    using namespace PluginParameterStateHelpers;
+
+    const int numParameters = parameters.size();
+
+    if (! shouldCompress)
+    {
+        destData.setSize (getSizeNeeded (numParameters));
+        writeTo (parameters, static_cast<char*> (destData.getData()));
+    }
+    else
+    {
+        juce::MemoryBlock entries ((size_t) numParameters * (size_t) entrySize);
+        writeEntries (static_cast<char*> (entries.getData()), parameters);
+
+        destData.setSize (headerSize);
+        writeHeader (static_cast<char*> (destData.getData()), (uint16) compressedFlag, (uint32) numParameters);
+
+        MemoryOutputStream out (destData, true);
+
+        {
+            GZIPCompressorOutputStream compressor (&out, 1);
+            compressor.write (entries.getData(), entries.getSize());
+        }
+    }
+}
+
+void PluginParameterState::writeTo (const OwnedArray<PluginParameter>& parameters, char* const destData) noexcept
+{
+    using namespace PluginParameterStateHelpers;
+
+    writeHeader (destData, 0, (uint32) parameters.size());
+    writeEntries (destData + headerSize, parameters);
+}
+
+bool PluginParameterState::read (const void* data, int sizeInBytes, OwnedArray<PluginParameter>& parameters)
+{
+    PluginParameterIndex index;
+    index.build (parameters);
+
+    PluginParameterStateHelpers::ParameterTarget target (parameters, index);
+    return PluginParameterStateHelpers::readEntries (data, sizeInBytes, target);
+}
+
+bool PluginParameterState::read (const void* data, int sizeInBytes, PluginParameterFrame& frame,
+                                 const PluginParameterIndex& index)
+{
+    PluginParameterStateHelpers::FrameTarget target (frame, index);
+    return PluginParameterStateHelpers::readEntries (data, sizeInBytes, target);
+}
+
+//END_JUCE_NAMESPACE
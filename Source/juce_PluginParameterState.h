@@ -0,0 +1,125 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERSTATE_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERSTATE_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameter.h"
+#include "juce_PluginParameterFrame.h"
+#include "juce_PluginParameterIndex.h"
+
+//==============================================================================
+/**
+    Reads and writes a set of parameter values in a compact binary format.
+
+    This is much quicker than building an XmlElement with one attribute per
+    parameter and then turning it into a string, which is what made large
+    parameter sets slow to save and load.
+
+    The layout is a 12 byte header followed by one 12 byte entry per parameter.
+    Everything is little-endian:
+    @code
+    uint32  magic       'PPSB'
+    uint16  version     currently 2
+    uint16  flags       0, or compressedFlag
+    uint32  numEntries
+
+    uint32  id          the hash of the parameter's identifier
+    float64 value       the full-scale value
+    @endcode
+
+    Storing identifier hashes rather than indexes means parameters can be added,
+    removed or reordered without breaking old state. Version 1 data, which used
+    the parameter's index as its id, is still read.
+
+    If compressedFlag is set, the entries after the header are compressed with
+    zlib at its fastest setting. Old data without the flag still loads as it is.
+
+    Entries with an id that isn't known are skipped, and parameters that
+    don't have an entry are left alone, so state saved by older or newer
+    builds with different parameter sets can still be loaded.
+
+    @see AudioProcessorExt::copyParametersToBinary
+ */
+class PluginParameterState
+{
+public:
+    //==============================================================================
+    enum
+    {
+        magicNumber     = 0x42535050,   /**< 'PPSB' when read as bytes. */
+        currentVersion  = 2,
+        headerSize      = 12,
+        entrySize       = 12,
+
+        compressedFlag  = 1,            /**< The entries are zlib compressed. */
+        knownFlags      = compressedFlag
+    };
+
+    /** Returns true if the data starts with a header this class can read. */
+    static bool isBinaryState (const void* data, int sizeInBytes) noexcept;
+
+    /** Returns the number of bytes write() will need for some uncompressed parameters. */
+    static size_t getSizeNeeded (int numParameters) noexcept;
+
+    /** Replaces the contents of a MemoryBlock with the values of some parameters.
+
+        Compressing only helps when many parameters share the same values, e.g.
+        large sets that are mostly left at their defaults. It costs some time and
+        a temporary allocation, so it's off by default.
+     */
+    static void write (const OwnedArray<PluginParameter>& parameters, juce::MemoryBlock& destData,
+                       bool shouldCompress = false);
+
+    /** Writes some parameters uncompressed, to getSizeNeeded() bytes of memory
+        that the caller has already allocated. This lets the values be saved
+        alongside some other state in a single block.
+     */
+    static void writeTo (const OwnedArray<PluginParameter>& parameters, char* destData) noexcept;
+
+    /** Sets the parameters from some data created by write().
+
+        The data is checked in one pass while it's being read, so truncated or
+        corrupt data is safe to pass in. If the header isn't valid nothing is
+        changed and this returns false.
+     */
+    static bool read (const void* data, int sizeInBytes, OwnedArray<PluginParameter>& parameters);
+
+    /** Decodes some data created by write() into a frame instead of the live
+        parameters. The frame should already have a slot for each parameter;
+        slots without an entry in the data are left empty. The index is used to
+        find the slot for each entry.
+     */
+    static bool read (const void* data, int sizeInBytes, PluginParameterFrame& frame,
+                      const PluginParameterIndex& index);
+
+private:
+    PluginParameterState();
+    JUCE_DECLARE_NON_COPYABLE (PluginParameterState);
+};
+
+#endif //__JUCE_PLUGINPARAMETERSTATE_JUCEHEADER__
@@ -0,0 +1,303 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginParameterText.h"
+
+PluginParameterText::PluginParameterText() noexcept
+    : cachedKey (0),
+      isValid (false)
+{
+    text[0] = 0;
+}
+
+void PluginParameterText::invalidate() noexcept
+{
+    const SpinLock::ScopedLockType sl (lock);
+    isValid = false;
+}
+
+int PluginParameterText::getNumDecimalPlacesForStep (double step) noexcept
+{
+    if (step <= 0.0)
+        return 2;
+
+    int numPlaces = 0;
+
+    while (numPlaces < 6 && fabs (step - floor (step + 0.5)) > 1.0e-9)
+    {
+        step *= 10.0;
+        ++numPlaces;
+    }
+
+    return numPlaces;
+}
+
+void PluginParameterText::copyText (const double value, const double min, const double step,
+                                    const String& suffix, char* const dest, const int maxBytes)
+{
+    if (dest == nullptr || maxBytes <= 0)
+        return;
+
+    // the key is the index of the nearest step, or the raw value if there's no step
+    int64 key;
+
+    if (step > 0.0)
+        key = (int64) floor ((value - min) / step + 0.5);
+    else
+        memcpy (&key, &value, sizeof (key));
+
+    const SpinLock::ScopedLockType sl (lock);
+
+    if (! isValid || key != cachedKey)
+    {
+        const double valueToShow = step > 0.0 ? min + (double) key * step : value;
+
+        String newText (valueToShow, getNumDecimalPlacesForStep (step));
+
+        if (suffix.isNotEmpty())
+            newText << " " << suffix;
+
+        newText.copyToUTF8 (text, (size_t) maxLength);
+        cachedKey = key;
+        isValid = true;
+    }
+
+    // copy up to the terminator, without splitting a multi-byte character
+    int length = 0;
+
+    while (length < maxLength && text[length] != 0)
+        ++length;
+
+    if (length >= maxBytes)
+    {
+        length = maxBytes - 1;
+
+        while (length > 0 && (text[length] & 0xc0) == 0x80)
+            --length;
+    }
+
+    memcpy (dest, text, (size_t) length);
+    dest[length] = 0;
+}
+
+//==============================================================================
+namespace PluginParameterTextHelpers
+{
+    inline bool isSpace (char c) noexcept       { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    inline bool isDigit (char c) noexcept       { return c >= '0' && c <= '9'; }
+    inline char toLower (char c) noexcept       { return (c >= 'A' && c <= 'Z') ? (char) (c + ('a' - 'A')) : c; }
+
+    inline void skipSpaces (const char*& t) noexcept
+    {
+        while (isSpace (*t))
+            ++t;
+    }
+
+    /** Moves past a word if the text starts with it, ignoring case. */
+    bool skipWord (const char*& t, const char* word) noexcept
+    {
+        const char* p = t;
+
+        for (; *word != 0; ++word, ++p)
+            if (toLower (*p) != toLower (*word))
+                return false;
+
+        t = p;
+        return true;
+    }
+
+    bool scanInteger (const char*& t, int& result) noexcept
+    {
+        const char* p = t;
+        const bool isNegative = (*p == '-');
+
+        if (*p == '-' || *p == '+')
+            ++p;
+
+        if (! isDigit (*p))
+            return false;
+
+        int value = 0;
+
+        while (isDigit (*p))
+            value = jmin (100000, value * 10 + (*p++ - '0'));
+
+        result = isNegative ? -value : value;
+        t = p;
+        return true;
+    }
+
+    /** Reads a number without using the C library, so the system locale can't
+        change what the decimal point is.
+     */
+    bool scanNumber (const char*& t, double& result) noexcept
+    {
+        const char* p = t;
+        const bool isNegative = (*p == '-');
+
+        if (*p == '-' || *p == '+')
+            ++p;
+
+        double mantissa = 0.0;
+        int numDigits = 0, numFractionDigits = 0;
+        bool isInFraction = false;
+
+        for (;; ++p)
+        {
+            if (isDigit (*p))
+            {
+                mantissa = mantissa * 10.0 + (*p - '0');
+                ++numDigits;
+
+                if (isInFraction)
+                    ++numFractionDigits;
+            }
+            else if ((*p == '.' || *p == ',') && ! isInFraction)
+            {
+                isInFraction = true;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (numDigits == 0)
+            return false;
+
+        int exponent = 0;
+
+        if (*p == 'e' || *p == 'E')
+        {
+            const char* e = p + 1;
+
+            if (scanInteger (e, exponent))
+                p = e;
+        }
+
+        exponent -= numFractionDigits;
+
+        // dividing by an exact power of ten rounds correctly, whereas
+        // multiplying by an inexact 10^-n doesn't, e.g. "0.3" would come out as
+        // 0.30000000000000004
+        if (exponent > 0)
+            mantissa *= pow (10.0, (double) exponent);
+        else if (exponent < 0)
+            mantissa /= pow (10.0, (double) -exponent);
+
+        result = isNegative ? -mantissa : mantissa;
+        t = p;
+        return true;
+    }
+
+    bool scanNoteName (const char*& t, double& result) noexcept
+    {
+        static const int semitones[] = { 9, 11, 0, 2, 4, 5, 7 }; // A B C D E F G
+
+        const char* p = t;
+        const char letter = toLower (*p);
+
+        if (letter < 'a' || letter > 'g')
+            return false;
+
+        int note = semitones [letter - 'a'];
+        ++p;
+
+        if (*p == '#')          { ++note; ++p; }
+        else if (*p == 'b')     { --note; ++p; }
+
+        int octave;
+
+        if (! scanInteger (p, octave))
+            return false;
+
+        result = (double) ((octave + 2) * 12 + note);
+        t = p;
+        return true;
+    }
+}
+
+bool PluginParameterText::parseText (const char* text, const ParameterUnit unit,
+                                     const String& suffix, double& result) noexcept
+{
+    using namespace PluginParameterTextHelpers;
+
+    if (text == nullptr)
+        return false;
+
+    const char* t = text;
+    skipSpaces (t);
+
+    double value;
+
+    if (unit == UnitMIDINoteNumber && scanNoteName (t, value))
+    {
+        skipSpaces (t);
+
+        if (*t != 0)
+            return false;
+
+        result = value;
+        return true;
+    }
+
+    if (! scanNumber (t, value))
+        return false;
+
+    skipSpaces (t);
+
+    const char* const suffixText = suffix.toUTF8();
+    const bool hasSuffix = suffixText != nullptr && *suffixText != 0;
+
+    // the suffix can be typed in full, or after a unit prefix
+    if (! (hasSuffix && skipWord (t, suffixText)))
+    {
+        if (unit == UnitSeconds && skipWord (t, "ms"))
+            value *= 0.001;
+        else if (unit == UnitMilliseconds && skipWord (t, "s"))
+            value *= 1000.0;
+        else if (*t == 'k' || *t == 'K')
+        {
+            value *= 1000.0;
+            ++t;
+        }
+
+        skipSpaces (t);
+
+        if (hasSuffix)
+            skipWord (t, suffixText);
+    }
+
+    skipSpaces (t);
+
+    if (*t != 0)
+        return false;
+
+    result = value;
+    return true;
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,102 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPARAMETERTEXT_JUCEHEADER__
+#define __JUCE_PLUGINPARAMETERTEXT_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameterHelpers.h"
+
+//==============================================================================
+/**
+    Caches the display text of a parameter's value.
+
+    Hosts poll the text of every visible parameter many times a second, and
+    most of the time the value hasn't moved. This keeps the last formatted text
+    in a fixed size buffer along with the step it was made for, so a repeated
+    request is just a compare and a copy. It's only formatted again when the
+    value moves to a different step, or after invalidate() has been called
+    because the suffix or step have changed.
+
+    @see PluginParameter::copyTextUTF8
+ */
+class PluginParameterText
+{
+public:
+    //==============================================================================
+    enum
+    {
+        maxLength = 32          /**< The most bytes of text stored, including the terminator. */
+    };
+
+    /** Creates an empty cache. */
+    PluginParameterText() noexcept;
+
+    //==============================================================================
+    /** Copies the text for a value into a buffer, formatting it first if needed.
+
+        The value is shown rounded to the nearest step above min, with as many
+        decimal places as the step needs, followed by a space and the suffix if
+        there is one. The text in dest is always null terminated, and is cut
+        short on a character boundary if it won't fit in maxBytes.
+     */
+    void copyText (double value, double min, double step, const String& suffix,
+                   char* dest, int maxBytes);
+
+    /** Forces the text to be formatted again the next time it's needed. */
+    void invalidate() noexcept;
+
+    /** Returns the number of decimal places needed to show multiples of a step. */
+    static int getNumDecimalPlacesForStep (double step) noexcept;
+
+    //==============================================================================
+    /** Turns some text typed by a user back into a full-scale value.
+
+        This understands:
+        - plain numbers, with either '.' or ',' as the decimal point, whatever the
+          system locale, and an optional exponent
+        - an optional unit suffix after the number, e.g. "-6 dB" or "50%"
+        - a 'k' multiplier, e.g. "1.5k" or "1.5 kHz" for 1500
+        - "ms" for UnitSeconds and "s" for UnitMilliseconds, e.g. "250 ms"
+        - note names like "C3", "F#4" or "Bb-1" for UnitMIDINoteNumber, with
+          C3 as middle C (60)
+
+        Returns false if the text couldn't be read, in which case result isn't
+        changed. The value isn't limited to any range. This doesn't allocate.
+     */
+    static bool parseText (const char* text, ParameterUnit unit, const String& suffix, double& result) noexcept;
+
+private:
+    //==============================================================================
+    char text [maxLength];
+    int64 cachedKey;
+    bool isValid;
+    SpinLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE (PluginParameterText);
+};
+
+#endif //__JUCE_PLUGINPARAMETERTEXT_JUCEHEADER__
@@ -0,0 +1,300 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginPresetBank.h"
+#include "juce_PluginParameterIndex.h"
+
+PluginPresetBank::PluginPresetBank()
+    : numPresets (0),
+      numParameters (0)
+{
+}
+
+PluginPresetBank::~PluginPresetBank()
+{
+}
+
+void PluginPresetBank::setSize (int newNumPresets, int newNumParameters)
+{
+    numPresets = jmax (0, newNumPresets);
+    numParameters = jmax (0, newNumParameters);
+
+    values.calloc ((size_t) jmax (1, numPresets * numParameters));
+    names.calloc ((size_t) jmax (1, numPresets * (int) maxNameLength));
+    identifierHashes.calloc ((size_t) jmax (1, numParameters));
+}
+
+void PluginPresetBank::initialise (int newNumPresets, const OwnedArray<PluginParameter>& parameters)
+{
+    setSize (newNumPresets, parameters.size());
+
+    for (int i = 0; i < numParameters; ++i)
+        identifierHashes[i] = parameters.getUnchecked (i)->getIdentifierHash();
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        storePreset (i, parameters);
+        setPresetName (i, "Program " + String (i + 1));
+    }
+}
+
+//==============================================================================
+const String PluginPresetBank::getPresetName (int presetIndex) const
+{
+    if (! isPositiveAndBelow (presetIndex, numPresets))
+        return String::empty;
+
+    const char* const name = names + presetIndex * (int) maxNameLength;
+    int length = 0;
+
+    while (length < (int) maxNameLength && name[length] != 0)
+        ++length;
+
+    return String::fromUTF8 (name, length);
+}
+
+void PluginPresetBank::setPresetName (int presetIndex, const String& newName)
+{
+    if (isPositiveAndBelow (presetIndex, numPresets))
+    {
+        char* const name = names + presetIndex * (int) maxNameLength;
+        zeromem (name, (size_t) maxNameLength);
+
+        const char* const utf8 = newName.toUTF8();
+        size_t numBytes = strlen (utf8);
+
+        if (numBytes > (size_t) maxNameLength)
+        {
+            // back up to the start of the character that doesn't fit, so the
+            // stored name never ends with part of a multi-byte sequence
+            numBytes = (size_t) maxNameLength;
+
+            while (numBytes > 0 && (utf8 [numBytes] & 0xc0) == 0x80)
+                --numBytes;
+        }
+
+        memcpy (name, utf8, numBytes);
+    }
+}
+
+const double* PluginPresetBank::getPresetValues (int presetIndex) const noexcept
+{
+    return isPositiveAndBelow (presetIndex, numPresets) ? values + presetIndex * numParameters
+                                                        : nullptr;
+}
+
+void PluginPresetBank::storePreset (int presetIndex, const OwnedArray<PluginParameter>& parameters)
+{
+    if (isPositiveAndBelow (presetIndex, numPresets))
+    {
+        double* const row = values + presetIndex * numParameters;
+        const int numToStore = jmin (numParameters, parameters.size());
+
+        for (int i = 0; i < numToStore; ++i)
+            row[i] = parameters.getUnchecked (i)->getValue();
+    }
+}
+
+void PluginPresetBank::storePresetValue (int presetIndex, int parameterIndex, double value) noexcept
+{
+    if (isPositiveAndBelow (presetIndex, numPresets) && isPositiveAndBelow (parameterIndex, numParameters))
+        values [presetIndex * numParameters + parameterIndex] = value;
+}
+
+void PluginPresetBank::applyPreset (int presetIndex, OwnedArray<PluginParameter>& parameters) const
+{
+    const double* const row = getPresetValues (presetIndex);
+
+    if (row != nullptr)
+    {
+        const int numToApply = jmin (numParameters, parameters.size());
+
+        for (int i = 0; i < numToApply; ++i)
+        {
+            PluginParameter* const parameter = parameters.getUnchecked (i);
+            parameter->setValue (row[i]);
+
+            if (! isGainUnit (parameter->getUnit()))
+                parameter->resetSmoothing();
+        }
+    }
+}
+
+void PluginPresetBank::copyPresetToFrame (int presetIndex, PluginParameterFrame& frame) const noexcept
+{
+    const double* const row = getPresetValues (presetIndex);
+
+    if (row != nullptr)
+    {
+        const int numToCopy = jmin (numParameters, frame.getNumParameters());
+
+        for (int i = 0; i < numToCopy; ++i)
+            frame.setValue (i, row[i]);
+    }
+}
+
+//==============================================================================
+size_t PluginPresetBank::getSizeInBytes() const noexcept
+{
+    return (size_t) headerSize
+            + (size_t) numParameters * sizeof (uint32)
+            + (size_t) numPresets * (size_t) maxNameLength
+            + (size_t) numPresets * (size_t) numParameters * sizeof (double);
+}
+
+void PluginPresetBank::saveToMemoryBlock (juce::MemoryBlock& destData) const
+{
+    destData.setSize (getSizeInBytes());
+    writeTo (static_cast<char*> (destData.getData()));
+}
+
+void PluginPresetBank::writeTo (char* d) const noexcept
+{
+    const size_t namesSize = (size_t) numPresets * (size_t) maxNameLength;
+    const size_t numValues = (size_t) numPresets * (size_t) numParameters;
+
+    *(uint32*) d        = ByteOrder::swapIfBigEndian ((uint32) magicNumber);
+    *(uint16*) (d + 4)  = ByteOrder::swapIfBigEndian ((uint16) currentVersion);
+    *(uint16*) (d + 6)  = 0;
+    *(uint32*) (d + 8)  = ByteOrder::swapIfBigEndian ((uint32) numPresets);
+    *(uint32*) (d + 12) = ByteOrder::swapIfBigEndian ((uint32) numParameters);
+    d += headerSize;
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        *(uint32*) d = ByteOrder::swapIfBigEndian (identifierHashes[i]);
+        d += sizeof (uint32);
+    }
+
+    if (namesSize > 0)
+        memcpy (d, names, namesSize);
+
+    d += namesSize;
+
+    for (size_t i = 0; i < numValues; ++i)
+    {
+        uint64 bits;
+        memcpy (&bits, values + i, sizeof (bits));
+        bits = ByteOrder::swapIfBigEndian (bits);
+        memcpy (d, &bits, sizeof (bits));
+        d += sizeof (bits);
+    }
+}
+
+bool PluginPresetBank::loadFromData (const void* data, int sizeInBytes,
+                                     const OwnedArray<PluginParameter>& parameters)
+{
+    if (data == nullptr || sizeInBytes < (int) headerSize)
+        return false;
+
+    const char* d = static_cast<const char*> (data);
+    const uint16 version = ByteOrder::littleEndianShort (d + 4);
+
+    if (ByteOrder::littleEndianInt (d) != (uint32) magicNumber
+         || version > (uint16) currentVersion
+         || ByteOrder::littleEndianShort (d + 6) != 0)
+        return false;
+
+    const uint32 savedNumPresets = ByteOrder::littleEndianInt (d + 8);
+    const uint32 savedNumParameters = ByteOrder::littleEndianInt (d + 12);
+    const bool hasIds = version >= 2;
+
+    // check the table is all there before touching anything, using 64 bits so
+    // silly sizes in a corrupt header can't overflow
+    const uint64 idsSize = hasIds ? (uint64) savedNumParameters * sizeof (uint32) : 0;
+    const uint64 namesSize = (uint64) savedNumPresets * (uint64) maxNameLength;
+    const uint64 numSavedValues = (uint64) savedNumPresets * (uint64) savedNumParameters;
+
+    if ((uint64) headerSize + idsSize + namesSize + numSavedValues * sizeof (double) > (uint64) sizeInBytes)
+        return false;
+
+    d += headerSize;
+
+    // work out which parameter each saved column belongs to
+    PluginParameterIndex index;
+    index.build (parameters);
+
+    HeapBlock<int> columnTargets ((size_t) jmax (1u, savedNumParameters));
+
+    for (uint32 i = 0; i < savedNumParameters; ++i)
+    {
+        if (hasIds)
+        {
+            columnTargets[i] = index.getIndexForHash (ByteOrder::littleEndianInt (d));
+            d += sizeof (uint32);
+        }
+        else
+        {
+            columnTargets[i] = i < (uint32) parameters.size() ? (int) i : -1;
+        }
+    }
+
+    PluginPresetBank newBank;
+    newBank.setSize ((int) savedNumPresets, parameters.size());
+
+    for (int i = 0; i < newBank.numParameters; ++i)
+        newBank.identifierHashes[i] = parameters.getUnchecked (i)->getIdentifierHash();
+
+    if (namesSize > 0)
+        memcpy (newBank.names, d, (size_t) namesSize);
+
+    d += namesSize;
+
+    for (int preset = 0; preset < newBank.numPresets; ++preset)
+    {
+        double* const row = newBank.values + preset * newBank.numParameters;
+
+        for (int i = 0; i < newBank.numParameters; ++i)
+            row[i] = parameters.getUnchecked (i)->getDefault();
+
+        for (uint32 i = 0; i < savedNumParameters; ++i)
+        {
+            uint64 bits = ByteOrder::littleEndianInt64 (d);
+            d += sizeof (bits);
+
+            double value;
+            memcpy (&value, &bits, sizeof (value));
+
+            // skip columns we don't know about, and anything that isn't a real number
+            if (columnTargets[i] >= 0 && juce_isfinite (value))
+                row [columnTargets[i]] = value;
+        }
+    }
+
+    swapWith (newBank);
+    return true;
+}
+
+void PluginPresetBank::swapWith (PluginPresetBank& other) noexcept
+{
+    values.swapWith (other.values);
+    names.swapWith (other.names);
+    identifierHashes.swapWith (other.identifierHashes);
+    std::swap (numPresets, other.numPresets);
+    std::swap (numParameters, other.numParameters);
+}
+
+//END_JUCE_NAMESPACE
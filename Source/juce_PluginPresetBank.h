@@ -0,0 +1,161 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPRESETBANK_JUCEHEADER__
+#define __JUCE_PLUGINPRESETBANK_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameter.h"
+#include "juce_PluginParameterFrame.h"
+
+//==============================================================================
+/**
+    A bank of presets stored as one contiguous table of full-scale values.
+
+    Each preset is a row of getNumParameters() doubles, and each name is a fixed
+    size slot, so switching to a preset is just a walk along one row: there's
+    nothing to parse and nothing to allocate, however many presets there are.
+
+    Banks can be saved to and loaded from a block of memory, e.g. a file or a
+    BinaryData resource. The layout is little-endian:
+    @code
+    uint32  magic       'PPBK'
+    uint16  version     currently 2
+    uint16  flags       must be 0
+    uint32  numPresets
+    uint32  numParameters
+    uint32  ids [numParameters]                     identifier hashes
+    char    names [numPresets][maxNameLength]       null padded UTF-8
+    float64 values [numPresets][numParameters]
+    @endcode
+
+    The ids are the parameters' identifier hashes, so a saved bank still loads
+    after parameters have been added, removed or reordered. Version 1 data has
+    no ids, and its columns are matched to the parameters by position.
+ */
+class PluginPresetBank
+{
+public:
+    //==============================================================================
+    enum
+    {
+        magicNumber     = 0x4b425050,   /**< 'PPBK' when read as bytes. */
+        currentVersion  = 2,
+        headerSize      = 16,
+        maxNameLength   = 24            /**< The same as the VST program name limit. */
+    };
+
+    /** Creates an empty bank. */
+    PluginPresetBank();
+
+    /** Destructor. */
+    ~PluginPresetBank();
+
+    //==============================================================================
+    /** Changes the size of the bank.
+        Every preset is set to the values of the parameters passed in, and given
+        a name like "Program 1".
+     */
+    void initialise (int numPresets, const OwnedArray<PluginParameter>& parameters);
+
+    /** Returns the number of presets in the bank. */
+    int getNumPresets() const noexcept                          { return numPresets; }
+
+    /** Returns the number of values each preset holds. */
+    int getNumParameters() const noexcept                       { return numParameters; }
+
+    //==============================================================================
+    /** Returns the name of a preset. */
+    const String getPresetName (int presetIndex) const;
+
+    /** Renames a preset.
+        Names longer than maxNameLength bytes of UTF-8 are cut at the last whole
+        character that fits.
+     */
+    void setPresetName (int presetIndex, const String& newName);
+
+    /** Returns a preset's row of values, or nullptr if the index is out of range. */
+    const double* getPresetValues (int presetIndex) const noexcept;
+
+    /** Copies the current values of some parameters into a preset. */
+    void storePreset (int presetIndex, const OwnedArray<PluginParameter>& parameters);
+
+    /** Changes one value in a preset. */
+    void storePresetValue (int presetIndex, int parameterIndex, double value) noexcept;
+
+    /** Sets some parameters to the values stored in a preset.
+
+        This doesn't parse or allocate anything. Gain-like parameters glide to
+        their new values, anything else jumps straight there. Call
+        AudioProcessorExt::parameterValueChanged() for each parameter afterwards.
+     */
+    void applyPreset (int presetIndex, OwnedArray<PluginParameter>& parameters) const;
+
+    /** Copies a preset into a frame, which must already have a slot per parameter. */
+    void copyPresetToFrame (int presetIndex, PluginParameterFrame& frame) const noexcept;
+
+    //==============================================================================
+    /** Returns the number of bytes saveToMemoryBlock() will write. */
+    size_t getSizeInBytes() const noexcept;
+
+    /** Replaces the contents of a MemoryBlock with the whole bank. */
+    void saveToMemoryBlock (juce::MemoryBlock& destData) const;
+
+    /** Writes the whole bank in the same format as saveToMemoryBlock(), to
+        getSizeInBytes() bytes of memory that the caller has already allocated.
+        This lets it be saved alongside some other state in a single block.
+     */
+    void writeTo (char* destData) const noexcept;
+
+    /** Replaces the bank with one saved by saveToMemoryBlock().
+
+        The saved values are matched to the parameters by their identifiers, so
+        the bank ends up with one value per parameter in the same order. Values
+        the data doesn't have, or that aren't finite numbers, are set to the
+        parameter's default. Returns false and leaves the bank alone if the data
+        isn't valid.
+     */
+    bool loadFromData (const void* data, int sizeInBytes, const OwnedArray<PluginParameter>& parameters);
+
+    /** Swaps the contents of two banks. This doesn't allocate, so a bank can be
+        loaded on one thread and swapped in while holding a lock the audio
+        thread uses.
+     */
+    void swapWith (PluginPresetBank& other) noexcept;
+
+private:
+    //==============================================================================
+    HeapBlock<double> values;
+    HeapBlock<char> names;
+    HeapBlock<uint32> identifierHashes;
+    int numPresets, numParameters;
+
+    void setSize (int numPresets, int numParameters);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginPresetBank);
+};
+
+#endif //__JUCE_PLUGINPRESETBANK_JUCEHEADER__
@@ -0,0 +1,173 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_PluginPresetMorpher.h"
+
+PluginPresetMorpher::PluginPresetMorpher()
+    : numParameters (0),
+      maxNumSources (0)
+{
+}
+
+PluginPresetMorpher::~PluginPresetMorpher()
+{
+}
+
+void PluginPresetMorpher::prepare (const OwnedArray<PluginParameter>& parameters, int maxNumSources_)
+{
+    numParameters = parameters.size();
+    maxNumSources = jmax (1, maxNumSources_);
+
+    const size_t numSlots = (size_t) jmax (1, numParameters);
+    mins.malloc (numSlots);
+    ranges.malloc (numSlots);
+    skews.malloc (numSlots);
+    steps.malloc (numSlots);
+    blended.calloc (numSlots);
+    types.malloc (numSlots);
+    morphable.malloc (numSlots);
+    sources.calloc (numSlots * (size_t) maxNumSources);
+    weightBuffer.calloc ((size_t) maxNumSources);
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        PluginParameter* const parameter = parameters.getUnchecked (i);
+
+        mins[i]   = parameter->getMin();
+        ranges[i] = parameter->getMax() - parameter->getMin();
+        skews[i]  = parameter->getSkewFactor();
+        steps[i]  = parameter->getStep();
+        morphable[i] = true;
+
+        switch (parameter->getUnit())
+        {
+            case UnitIndexed:   types[i] = (uint8) indexed;     break;
+            case UnitBoolean:   types[i] = (uint8) boolean;     break;
+            default:            types[i] = (uint8) continuous;  break;
+        }
+    }
+}
+
+void PluginPresetMorpher::setMorphable (int parameterIndex, bool shouldBeMorphable) noexcept
+{
+    // this is kept apart from the type, so that turning morphing back on
+    // doesn't lose how an indexed or boolean parameter should be rounded
+    if (isPositiveAndBelow (parameterIndex, numParameters))
+        morphable[parameterIndex] = shouldBeMorphable;
+}
+
+bool PluginPresetMorpher::isMorphable (int parameterIndex) const noexcept
+{
+    return isPositiveAndBelow (parameterIndex, numParameters)
+            && morphable[parameterIndex];
+}
+
+//==============================================================================
+void PluginPresetMorpher::setSource (int sourceIndex, const double* fullScaleValues) noexcept
+{
+    if (fullScaleValues == nullptr || ! isPositiveAndBelow (sourceIndex, maxNumSources))
+        return;
+
+    double* const proportions = sources + sourceIndex * numParameters;
+
+    for (int i = 0; i < numParameters; ++i)
+    {
+        double proportion = ranges[i] > 0.0 ? jlimit (0.0, 1.0, (fullScaleValues[i] - mins[i]) / ranges[i])
+                                            : 0.0;
+
+        if (skews[i] != 1.0 && proportion > 0.0)
+            proportion = exp (log (proportion) * skews[i]);
+
+        proportions[i] = proportion;
+    }
+}
+
+double PluginPresetMorpher::toFullScale (int i, double proportion) const noexcept
+{
+    if (skews[i] != 1.0 && proportion > 0.0)
+        proportion = exp (log (proportion) / skews[i]);
+
+    double value = mins[i] + ranges[i] * proportion;
+
+    if (types[i] == (uint8) indexed && steps[i] > 0.0)
+        value = mins[i] + steps[i] * floor ((value - mins[i]) / steps[i] + 0.5);
+    else if (types[i] == (uint8) boolean)
+        value = proportion >= 0.5 ? mins[i] + ranges[i] : mins[i];
+
+    return value;
+}
+
+void PluginPresetMorpher::morph (const float* weights, int numWeights, OwnedArray<PluginParameter>& parameters) noexcept
+{
+    numWeights = jmin (numWeights, maxNumSources);
+
+    double totalWeight = 0.0;
+
+    for (int s = 0; s < numWeights; ++s)
+        totalWeight += jmax (0.0f, weights[s]);
+
+    if (numWeights <= 0 || totalWeight <= 0.0)
+        return;
+
+    // the blend is a plain multiply-add over contiguous rows, so keep the inner
+    // loop free of branches and calls so that it gets vectorised
+    zeromem (blended, sizeof (double) * (size_t) numParameters);
+
+    for (int s = 0; s < numWeights; ++s)
+    {
+        const double w = jmax (0.0f, weights[s]) / totalWeight;
+        const double* const src = sources + s * numParameters;
+        double* const dest = blended;
+
+        if (w > 0.0)
+            for (int i = 0; i < numParameters; ++i)
+                dest[i] += w * src[i];
+    }
+
+    const int numToSet = jmin (numParameters, parameters.size());
+
+    for (int i = 0; i < numToSet; ++i)
+        if (morphable[i])
+            parameters.getUnchecked (i)->setValue (toFullScale (i, blended[i]));
+}
+
+void PluginPresetMorpher::morphAlong (float position, OwnedArray<PluginParameter>& parameters) noexcept
+{
+    position = jlimit (0.0f, (float) (maxNumSources - 1), position);
+
+    const int lower = jmin ((int) position, maxNumSources - 1);
+    const float amount = position - (float) lower;
+
+    zeromem (weightBuffer, sizeof (float) * (size_t) maxNumSources);
+    weightBuffer[lower] = 1.0f - amount;
+
+    if (lower + 1 < maxNumSources)
+        weightBuffer[lower + 1] = amount;
+
+    morph (weightBuffer, maxNumSources, parameters);
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,115 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_PLUGINPRESETMORPHER_JUCEHEADER__
+#define __JUCE_PLUGINPRESETMORPHER_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include "juce_PluginParameter.h"
+
+//==============================================================================
+/**
+    Blends between two or more sets of parameter values.
+
+    The sources are usually rows from a PluginPresetBank. When a source is set,
+    its values are converted to each parameter's skewed 0 - 1 range (the same
+    mapping a slider uses), so blending is perceptually even. Each morph() is
+    then a weighted sum of contiguous arrays, which the compiler can vectorise,
+    followed by one pass mapping the results back to full-scale values.
+
+    UnitIndexed parameters snap to the nearest step and UnitBoolean parameters
+    switch at the half-way point. Results are set with PluginParameter::setValue()
+    and aren't jumped to, so they follow each parameter's normal smoothing. The
+    morpher doesn't know about the processor, so call
+    AudioProcessorExt::parameterValueChanged() for each morphable parameter
+    afterwards.
+
+    All the memory is allocated by prepare(); setSource() and morph() don't
+    allocate, so they can be called on the audio thread.
+ */
+class PluginPresetMorpher
+{
+public:
+    //==============================================================================
+    /** Creates an empty morpher. Call prepare() before using it. */
+    PluginPresetMorpher();
+
+    /** Destructor. */
+    ~PluginPresetMorpher();
+
+    //==============================================================================
+    /** Reads the ranges of some parameters and allocates room for a number of sources.
+        Call this again if the parameters' ranges change.
+     */
+    void prepare (const OwnedArray<PluginParameter>& parameters, int maxNumSources);
+
+    /** Returns the number of sources prepare() made room for. */
+    int getMaxNumSources() const noexcept                   { return maxNumSources; }
+
+    /** Stops a parameter being changed by morph(), e.g. the control doing the morphing. */
+    void setMorphable (int parameterIndex, bool shouldBeMorphable) noexcept;
+
+    /** Returns true if morph() will change a parameter. */
+    bool isMorphable (int parameterIndex) const noexcept;
+
+    //==============================================================================
+    /** Sets one of the sources from an array of full-scale values, one per parameter. */
+    void setSource (int sourceIndex, const double* fullScaleValues) noexcept;
+
+    /** Blends the sources and sets the parameters to the result.
+
+        The weights don't have to add up to 1, they're normalised here. Sources
+        beyond numWeights aren't used.
+     */
+    void morph (const float* weights, int numWeights, OwnedArray<PluginParameter>& parameters) noexcept;
+
+    /** Morphs along the chain of sources with a single control.
+        A position of 0 gives source 0, 1 gives source 1, 1.5 is half-way between
+        sources 1 and 2, and so on up to getMaxNumSources() - 1.
+     */
+    void morphAlong (float position, OwnedArray<PluginParameter>& parameters) noexcept;
+
+private:
+    //==============================================================================
+    enum MorphType
+    {
+        continuous,
+        indexed,
+        boolean
+    };
+
+    int numParameters, maxNumSources;
+    HeapBlock<double> mins, ranges, skews, steps, blended, sources;
+    HeapBlock<float> weightBuffer;
+    HeapBlock<uint8> types;
+    HeapBlock<bool> morphable;
+
+    double toFullScale (int parameterIndex, double proportion) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginPresetMorpher);
+};
+
+#endif //__JUCE_PLUGINPRESETMORPHER_JUCEHEADER__
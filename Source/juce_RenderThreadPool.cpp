@@ -0,0 +1,126 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+//BEGIN_JUCE_NAMESPACE
+#include "juce_RenderThreadPool.h"
+
+//==============================================================================
+class RenderThreadPool::Worker  : public Thread
+{
+public:
+    Worker (RenderThreadPool& owner_, int threadIndex_)
+        : Thread ("Offline Render Thread"),
+          owner (owner_),
+          threadIndex (threadIndex_)
+    {
+    }
+
+    ~Worker()
+    {
+        signalThreadShouldExit();
+        startEvent.signal();
+        stopThread (5000);
+    }
+
+    void startChunks()
+    {
+        finishedEvent.reset();
+        startEvent.signal();
+    }
+
+    void waitForChunks()
+    {
+        finishedEvent.wait();
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            startEvent.wait();
+
+            if (threadShouldExit())
+                return;
+
+            owner.processChunksForThread (threadIndex);
+            finishedEvent.signal();
+        }
+    }
+
+private:
+    RenderThreadPool& owner;
+    const int threadIndex;
+    WaitableEvent startEvent, finishedEvent;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker);
+};
+
+//==============================================================================
+RenderThreadPool::RenderThreadPool (int numHelperThreads)
+    : currentJob (nullptr),
+      currentNumChunks (0)
+{
+    for (int i = 0; i < numHelperThreads; ++i)
+    {
+        Worker* const worker = workers.add (new Worker (*this, i + 1));
+        worker->startThread (8);
+    }
+}
+
+RenderThreadPool::~RenderThreadPool()
+{
+    workers.clear();
+}
+
+void RenderThreadPool::run (Job& job, const int numChunks)
+{
+    if (numChunks <= 0)
+        return;
+
+    const int numWorkersNeeded = jmin (workers.size(), numChunks - 1);
+
+    currentJob = &job;
+    currentNumChunks = numChunks;
+
+    for (int i = 0; i < numWorkersNeeded; ++i)
+        workers.getUnchecked (i)->startChunks();
+
+    processChunksForThread (0);
+
+    for (int i = 0; i < numWorkersNeeded; ++i)
+        workers.getUnchecked (i)->waitForChunks();
+
+    currentJob = nullptr;
+}
+
+void RenderThreadPool::processChunksForThread (const int threadIndex)
+{
+    const int numThreads = jmin (getNumThreads(), currentNumChunks);
+
+    for (int i = threadIndex; i < currentNumChunks; i += numThreads)
+        currentJob->processChunk (i);
+}
+
+//END_JUCE_NAMESPACE
@@ -0,0 +1,90 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2004-11 by Raw Material Software Ltd.
+
+ ------------------------------------------------------------------------------
+
+ JUCE can be redistributed and/or modified under the terms of the GNU General
+ Public License (Version 2), as published by the Free Software Foundation.
+ A copy of the license is included in the JUCE distribution, or can be found
+ online at www.gnu.org/licenses.
+
+ JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+ ------------------------------------------------------------------------------
+
+ To release a closed-source product which uses JUCE, commercial licenses are
+ available: visit www.rawmaterialsoftware.com/juce for more information.
+
+ ==============================================================================
+ */
+
+#ifndef __JUCE_RENDERTHREADPOOL_JUCEHEADER__
+#define __JUCE_RENDERTHREADPOOL_JUCEHEADER__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/**
+    A small set of worker threads used to split a block of audio processing
+    into independent chunks (usually channels) while rendering offline.
+
+    Chunks are always handed out in the same way: the calling thread takes
+    chunks 0, n, 2n... and worker i takes chunks i + 1, i + 1 + n... where n is
+    the total number of threads. As long as each chunk only touches its own
+    state the result is identical to processing them one after another, so
+    an offline bounce stays bit-exact however many threads are used.
+
+    @see AudioProcessorExt::processChannelsInParallel
+ */
+class RenderThreadPool
+{
+public:
+    //==============================================================================
+    /** A piece of work that can be split into numbered chunks. */
+    class Job
+    {
+    public:
+        virtual ~Job() {}
+
+        /** Processes one chunk. This may be called on any of the pool's threads. */
+        virtual void processChunk (int chunkIndex) = 0;
+    };
+
+    //==============================================================================
+    /** Creates a pool with a number of helper threads.
+        The thread calling run() also does some of the work, so a pool created
+        with 3 helpers will process up to 4 chunks at a time.
+     */
+    explicit RenderThreadPool (int numHelperThreads);
+
+    /** Destructor. This stops and deletes all the helper threads. */
+    ~RenderThreadPool();
+
+    /** Returns the total number of threads run() will use, including the caller. */
+    int getNumThreads() const noexcept                  { return workers.size() + 1; }
+
+    /** Calls job.processChunk() for each index from 0 to numChunks - 1 and
+        returns once they've all finished.
+     */
+    void run (Job& job, int numChunks);
+
+private:
+    //==============================================================================
+    class Worker;
+    friend class Worker;
+    OwnedArray<Worker> workers;
+
+    Job* currentJob;
+    int currentNumChunks;
+
+    void processChunksForThread (int threadIndex);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderThreadPool);
+};
+
+#endif //__JUCE_RENDERTHREADPOOL_JUCEHEADER__
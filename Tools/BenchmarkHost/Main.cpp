@@ -0,0 +1,564 @@
+/*
+  ==============================================================================
+
+    A headless VST host for measuring the plugin's performance on Linux.
+
+    It loads the plugin's .so through its VST entry point, feeds it synthetic
+    audio and automation at each of the block sizes and sample rates asked
+    for, and reports how much faster than real-time it runs, how long the
+    blocks take, and how many allocations the audio thread makes.
+
+    Each test runs through processReplacing() and then through the older
+    accumulating process() call, which must also render without allocating;
+    the host exits with an error if it doesn't.
+
+    With --midi, each block also gets that many note events, and the events
+    the plugin sends back are counted so MIDI throughput and any events the
+    plugin drops show up in the results.
+
+    Run it with no arguments to see the options.
+
+  ==============================================================================
+*/
+
+#include <pluginterfaces/vst2.x/aeffectx.h>
+
+#include <dlfcn.h>
+#include <time.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*  Allocation counting.
+
+    malloc and friends are replaced for the whole process, so this catches
+    operator new and anything the plugin allocates directly. Only allocations
+    made by a thread that has turned counting on are counted, so the plugin's
+    own background threads don't show up.
+*/
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void  __libc_free (void*);
+}
+
+namespace AllocationCounter
+{
+    static __thread bool isCounting = false;
+    static __thread long numAllocations = 0;
+    static __thread long numBytes = 0;
+
+    inline void add (size_t size)
+    {
+        if (isCounting)
+        {
+            ++numAllocations;
+            numBytes += (long) size;
+        }
+    }
+
+    void start()    { numAllocations = 0; numBytes = 0; isCounting = true; }
+    void stop()     { isCounting = false; }
+}
+
+extern "C"
+{
+    void* malloc (size_t size)                      { AllocationCounter::add (size); return __libc_malloc (size); }
+    void* calloc (size_t num, size_t size)          { AllocationCounter::add (num * size); return __libc_calloc (num, size); }
+    void* realloc (void* p, size_t size)            { AllocationCounter::add (size); return __libc_realloc (p, size); }
+    void* memalign (size_t alignment, size_t size)  { AllocationCounter::add (size); return __libc_memalign (alignment, size); }
+    void* aligned_alloc (size_t alignment, size_t size)  { return memalign (alignment, size); }
+    void  free (void* p)                            { __libc_free (p); }
+
+    int posix_memalign (void** result, size_t alignment, size_t size)
+    {
+        *result = memalign (alignment, size);
+        return *result != 0 ? 0 : 12 /* ENOMEM */;
+    }
+}
+
+//==============================================================================
+namespace
+{
+    struct Options
+    {
+        Options()
+            : seconds (10.0), warmUpSeconds (0.5), numAutomatedParameters (0),
+              automationRate (1), numMidiEventsPerBlock (0), csv (false)
+        {
+        }
+
+        std::string pluginPath;
+        std::vector<double> sampleRates;
+        std::vector<int> blockSizes;
+        double seconds, warmUpSeconds;
+        int numAutomatedParameters, automationRate, numMidiEventsPerBlock;
+        bool csv;
+    };
+
+    struct Result
+    {
+        bool accumulating;
+        double sampleRate;
+        int blockSize;
+        long numBlocks;
+        double realTimeFactor;
+        double p50, p90, p99, p999, maxTime;    // in microseconds
+        long numAllocations, numBytesAllocated;
+        long numMidiEventsSent, numMidiEventsReceived;
+        double midiEventsPerSecond;
+    };
+
+    //==============================================================================
+    // The host callback doesn't get told which host it belongs to, so the few
+    // things the plugin can ask about are kept here.
+    struct HostState
+    {
+        double sampleRate;
+        int blockSize;
+        double samplePosition;
+        VstTimeInfo timeInfo;
+        long numMidiEventsReceived;
+    };
+
+    HostState host;
+
+    VstIntPtr VSTCALLBACK hostCallback (AEffect*, VstInt32 opcode, VstInt32, VstIntPtr, void* ptr, float)
+    {
+        switch (opcode)
+        {
+            case audioMasterVersion:                    return 2400;
+            case audioMasterGetSampleRate:              return (VstIntPtr) host.sampleRate;
+            case audioMasterGetBlockSize:               return (VstIntPtr) host.blockSize;
+            case audioMasterGetCurrentProcessLevel:     return kVstProcessLevelRealtime;
+
+            case audioMasterProcessEvents:
+                if (ptr != 0)
+                    host.numMidiEventsReceived += ((const VstEvents*) ptr)->numEvents;
+
+                return 1;
+
+            case audioMasterGetTime:
+            {
+                const double tempo = 120.0;
+
+                memset (&host.timeInfo, 0, sizeof (host.timeInfo));
+                host.timeInfo.samplePos = host.samplePosition;
+                host.timeInfo.sampleRate = host.sampleRate;
+                host.timeInfo.tempo = tempo;
+                host.timeInfo.ppqPos = host.samplePosition / host.sampleRate * tempo / 60.0;
+                host.timeInfo.timeSigNumerator = 4;
+                host.timeInfo.timeSigDenominator = 4;
+                host.timeInfo.flags = kVstTransportPlaying | kVstTempoValid | kVstPpqPosValid | kVstTimeSigValid;
+                return (VstIntPtr) &host.timeInfo;
+            }
+
+            case audioMasterGetVendorString:
+                strcpy ((char*) ptr, "dRowAudio");
+                return 1;
+
+            case audioMasterGetProductString:
+                strcpy ((char*) ptr, "BenchmarkHost");
+                return 1;
+
+            default:
+                break;
+        }
+
+        return 0;
+    }
+
+    //==============================================================================
+    double getTimeMicroseconds()
+    {
+        timespec t;
+        clock_gettime (CLOCK_MONOTONIC, &t);
+        return t.tv_sec * 1.0e6 + t.tv_nsec * 1.0e-3;
+    }
+
+    double getPercentile (const std::vector<double>& sortedTimes, const double proportion)
+    {
+        if (sortedTimes.empty())
+            return 0.0;
+
+        return sortedTimes [(size_t) (proportion * (sortedTimes.size() - 1) + 0.5)];
+    }
+
+    AEffect* loadPlugin (const std::string& path)
+    {
+        void* const library = dlopen (path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+        if (library == 0)
+        {
+            fprintf (stderr, "Couldn't load %s: %s\n", path.c_str(), dlerror());
+            return 0;
+        }
+
+        typedef AEffect* (*MainCall) (audioMasterCallback);
+        const char* const entryPoints[] = { "VSTPluginMain", "main_plugin", "main" };
+
+        for (size_t i = 0; i < sizeof (entryPoints) / sizeof (entryPoints[0]); ++i)
+        {
+            if (MainCall mainCall = (MainCall) dlsym (library, entryPoints[i]))
+            {
+                AEffect* const effect = mainCall (hostCallback);
+
+                if (effect != 0 && effect->magic == kEffectMagic)
+                    return effect;
+
+                fprintf (stderr, "%s didn't return a VST effect\n", path.c_str());
+                return 0;
+            }
+        }
+
+        fprintf (stderr, "%s doesn't have a VST entry point\n", path.c_str());
+        return 0;
+    }
+
+    VstIntPtr dispatch (AEffect* effect, VstInt32 opcode, VstInt32 index = 0, VstIntPtr value = 0,
+                        float opt = 0.0f, void* ptr = 0)
+    {
+        return effect->dispatcher (effect, opcode, index, value, ptr, opt);
+    }
+
+    bool canDo (AEffect* effect, const char* what)
+    {
+        return dispatch (effect, effCanDo, 0, 0, 0.0f, (void*) what) > 0;
+    }
+
+    //==============================================================================
+    /** A VstEvents list of note-ons and note-offs spread over a block, built once
+        so that sending it doesn't allocate.
+    */
+    class MidiInputList
+    {
+    public:
+        MidiInputList (const int numEvents, const int blockSize)
+            : listData (sizeof (VstEvents) + sizeof (VstEvent*) * (size_t) std::max (0, numEvents - 2)),
+              events ((size_t) std::max (0, numEvents))
+        {
+            VstEvents* const list = getEvents();
+            list->numEvents = numEvents;
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                VstMidiEvent& e = events [(size_t) i];
+                memset (&e, 0, sizeof (e));
+                e.type = kVstMidiType;
+                e.byteSize = sizeof (VstMidiEvent);
+                e.deltaFrames = (VstInt32) (i * (long) blockSize / numEvents);
+                e.midiData[0] = (char) ((i & 1) == 0 ? 0x90 : 0x80);
+                e.midiData[1] = (char) (36 + (i / 2) % 60);
+                e.midiData[2] = (char) 100;
+
+                list->events[i] = (VstEvent*) &e;
+            }
+        }
+
+        VstEvents* getEvents()      { return (VstEvents*) &listData[0]; }
+
+    private:
+        std::vector<char> listData;
+        std::vector<VstMidiEvent> events;
+    };
+
+    //==============================================================================
+    /** Fills some buffers with a quiet sine wave and a little noise. */
+    void fillInputs (std::vector<float*>& channels, const int numSamples, const double startSample, const double sampleRate)
+    {
+        const double delta = 2.0 * M_PI * 440.0 / sampleRate;
+
+        for (size_t ch = 0; ch < channels.size(); ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                channels[ch][i] = 0.25f * (float) sin ((startSample + i) * delta)
+                                   + 0.01f * ((rand() / (float) RAND_MAX) - 0.5f);
+    }
+
+    Result runBenchmark (AEffect* effect, const Options& options, const double sampleRate,
+                         const int blockSize, const bool accumulating)
+    {
+        host.sampleRate = sampleRate;
+        host.blockSize = blockSize;
+        host.samplePosition = 0.0;
+
+        MidiInputList midiInput (options.numMidiEventsPerBlock, blockSize);
+        const bool sendsMidi = options.numMidiEventsPerBlock > 0;
+
+        dispatch (effect, effSetSampleRate, 0, 0, (float) sampleRate);
+        dispatch (effect, effSetBlockSize, 0, blockSize);
+        dispatch (effect, effMainsChanged, 0, 1);
+        dispatch (effect, effStartProcess);
+
+        const int numIns = std::max (1, effect->numInputs);
+        const int numOuts = std::max (1, effect->numOutputs);
+        std::vector<float> inputData ((size_t) (numIns * blockSize)), outputData ((size_t) (numOuts * blockSize));
+        std::vector<float*> inputs, outputs;
+
+        for (int i = 0; i < numIns; ++i)    inputs.push_back (&inputData [(size_t) (i * blockSize)]);
+        for (int i = 0; i < numOuts; ++i)   outputs.push_back (&outputData [(size_t) (i * blockSize)]);
+
+        const long numWarmUpBlocks = (long) (options.warmUpSeconds * sampleRate / blockSize);
+        const long numBlocks = std::max (1L, (long) (options.seconds * sampleRate / blockSize));
+        const int numParams = effect->numParams;
+
+        std::vector<double> times;
+        times.reserve ((size_t) numBlocks);
+
+        double totalTime = 0.0;
+        long numAllocations = 0, numBytesAllocated = 0;
+        long numMidiEventsSent = 0, numMidiEventsReceived = 0;
+
+        for (long block = -numWarmUpBlocks; block < numBlocks; ++block)
+        {
+            fillInputs (inputs, blockSize, host.samplePosition, sampleRate);
+
+            if (accumulating)
+                std::fill (outputData.begin(), outputData.end(), 0.0f);
+
+            const bool isMeasuring = block >= 0;
+
+            if (isMeasuring)
+                AllocationCounter::start();
+
+            host.numMidiEventsReceived = 0;
+            const double startTime = getTimeMicroseconds();
+
+            if (sendsMidi)
+                dispatch (effect, effProcessEvents, 0, 0, 0.0f, midiInput.getEvents());
+
+            // automation arrives on the audio thread just before the block, like most hosts do it
+            if (numParams > 0 && block % options.automationRate == 0)
+            {
+                for (int i = 0; i < options.numAutomatedParameters; ++i)
+                {
+                    const double phase = host.samplePosition / sampleRate + i / (double) options.numAutomatedParameters;
+                    effect->setParameter (effect, i % numParams, 0.5f + 0.5f * (float) sin (2.0 * M_PI * 0.25 * phase));
+                }
+            }
+
+            if (accumulating)
+                effect->DECLARE_VST_DEPRECATED (process) (effect, &inputs[0], &outputs[0], blockSize);
+            else
+                effect->processReplacing (effect, &inputs[0], &outputs[0], blockSize);
+
+            const double elapsed = getTimeMicroseconds() - startTime;
+
+            if (isMeasuring)
+            {
+                AllocationCounter::stop();
+                numAllocations += AllocationCounter::numAllocations;
+                numBytesAllocated += AllocationCounter::numBytes;
+
+                times.push_back (elapsed);
+                totalTime += elapsed;
+
+                if (sendsMidi)
+                {
+                    numMidiEventsSent += options.numMidiEventsPerBlock;
+                    numMidiEventsReceived += host.numMidiEventsReceived;
+                }
+            }
+
+            host.samplePosition += blockSize;
+        }
+
+        dispatch (effect, effStopProcess);
+        dispatch (effect, effMainsChanged, 0, 0);
+
+        std::sort (times.begin(), times.end());
+
+        Result r;
+        r.accumulating = accumulating;
+        r.sampleRate = sampleRate;
+        r.blockSize = blockSize;
+        r.numBlocks = numBlocks;
+        r.realTimeFactor = totalTime > 0.0 ? (numBlocks * (double) blockSize / sampleRate) * 1.0e6 / totalTime : 0.0;
+        r.p50 = getPercentile (times, 0.5);
+        r.p90 = getPercentile (times, 0.9);
+        r.p99 = getPercentile (times, 0.99);
+        r.p999 = getPercentile (times, 0.999);
+        r.maxTime = times.empty() ? 0.0 : times.back();
+        r.numAllocations = numAllocations;
+        r.numBytesAllocated = numBytesAllocated;
+        r.numMidiEventsSent = numMidiEventsSent;
+        r.numMidiEventsReceived = numMidiEventsReceived;
+        r.midiEventsPerSecond = totalTime > 0.0 ? numMidiEventsReceived * 1.0e6 / totalTime : 0.0;
+        return r;
+    }
+
+    //==============================================================================
+    template <typename Type>
+    bool parseList (const char* text, std::vector<Type>& dest)
+    {
+        dest.clear();
+
+        for (const char* t = text; *t != 0;)
+        {
+            char* end;
+            const double value = strtod (t, &end);
+
+            if (end == t || value <= 0)
+                return false;
+
+            dest.push_back ((Type) value);
+            t = (*end == ',') ? end + 1 : end;
+
+            if (*end != ',' && *end != 0)
+                return false;
+        }
+
+        return ! dest.empty();
+    }
+
+    bool parseOptions (int argc, char* argv[], Options& options)
+    {
+        options.sampleRates.push_back (44100.0);
+        options.blockSizes.push_back (64);
+        options.blockSizes.push_back (256);
+        options.blockSizes.push_back (1024);
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg (argv[i]);
+            const char* const next = (i + 1 < argc) ? argv[i + 1] : 0;
+
+            if (arg == "--csv")
+            {
+                options.csv = true;
+            }
+            else if (arg[0] != '-')
+            {
+                options.pluginPath = arg;
+            }
+            else if (next == 0)
+            {
+                return false;
+            }
+            else
+            {
+                ++i;
+
+                if (arg == "--rates")           { if (! parseList (next, options.sampleRates)) return false; }
+                else if (arg == "--blocks")     { if (! parseList (next, options.blockSizes)) return false; }
+                else if (arg == "--seconds")    options.seconds = atof (next);
+                else if (arg == "--warmup")     options.warmUpSeconds = atof (next);
+                else if (arg == "--automate")   options.numAutomatedParameters = atoi (next);
+                else if (arg == "--every")      options.automationRate = std::max (1, atoi (next));
+                else if (arg == "--midi")       options.numMidiEventsPerBlock = std::max (0, atoi (next));
+                else                            return false;
+            }
+        }
+
+        return ! options.pluginPath.empty() && options.seconds > 0.0;
+    }
+
+    void printUsage()
+    {
+        printf ("Usage: BenchmarkHost <plugin.so> [options]\n\n"
+                "  --rates 44100,96000    sample rates to test (default 44100)\n"
+                "  --blocks 64,256,1024   block sizes to test (default 64,256,1024)\n"
+                "  --seconds 10           length of audio to measure for each test\n"
+                "  --warmup 0.5           length of audio to process before measuring\n"
+                "  --automate 0           number of parameters to automate\n"
+                "  --every 1              automate every this many blocks\n"
+                "  --midi 0               number of MIDI events to send in each block\n"
+                "  --csv                  print the results as comma-separated values\n");
+    }
+
+    void printResult (const Result& r, const bool csv)
+    {
+        const char* const call = r.accumulating ? "process" : "replacing";
+
+        const long numMidiEventsDropped = r.numMidiEventsSent - r.numMidiEventsReceived;
+
+        if (csv)
+            printf ("%s,%.0f,%d,%ld,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%ld,%ld,%.0f,%ld\n",
+                    call, r.sampleRate, r.blockSize, r.numBlocks, r.realTimeFactor,
+                    r.p50, r.p90, r.p99, r.p999, r.maxTime,
+                    r.numAllocations, r.numBytesAllocated,
+                    r.midiEventsPerSecond, numMidiEventsDropped);
+        else
+            printf ("%-9s %8.0f %6d %10.1fx %9.2f %9.2f %9.2f %9.2f %9.2f %8ld %10ld %12.0f %8ld\n",
+                    call, r.sampleRate, r.blockSize, r.realTimeFactor,
+                    r.p50, r.p90, r.p99, r.p999, r.maxTime,
+                    r.numAllocations, r.numBytesAllocated,
+                    r.midiEventsPerSecond, numMidiEventsDropped);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Options options;
+
+    if (! parseOptions (argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    host.sampleRate = options.sampleRates[0];
+    host.blockSize = options.blockSizes[0];
+    host.samplePosition = 0.0;
+
+    AEffect* const effect = loadPlugin (options.pluginPath);
+
+    if (effect == 0)
+        return 1;
+
+    dispatch (effect, effOpen);
+
+    if (options.numMidiEventsPerBlock > 0
+         && ! (canDo (effect, "receiveVstMidiEvent") && canDo (effect, "sendVstMidiEvent")))
+    {
+        fprintf (stderr, "The plugin doesn't pass MIDI through, so --midi can't be measured\n");
+        options.numMidiEventsPerBlock = 0;
+    }
+
+    if (options.csv)
+        printf ("call,sampleRate,blockSize,numBlocks,realTimeFactor,p50us,p90us,p99us,p999us,maxus,allocations,bytesAllocated,"
+                "midiEventsOutPerSecond,midiEventsDropped\n");
+    else
+        printf ("%d inputs, %d outputs, %d parameters, automating %d\n\n"
+                "call          rate  block   realtime   p50(us)   p90(us)   p99(us) p99.9(us)   max(us)   allocs      bytes"
+                "   midi out/s  dropped\n",
+                effect->numInputs, effect->numOutputs, effect->numParams, options.numAutomatedParameters);
+
+    // the accumulating call is deprecated, but some hosts still use it
+    const bool canAccumulate = effect->DECLARE_VST_DEPRECATED (process) != 0;
+    long numAccumulatingAllocations = 0;
+
+    for (size_t i = 0; i < options.sampleRates.size(); ++i)
+    {
+        for (size_t j = 0; j < options.blockSizes.size(); ++j)
+        {
+            printResult (runBenchmark (effect, options, options.sampleRates[i], options.blockSizes[j], false), options.csv);
+
+            if (canAccumulate)
+            {
+                const Result r (runBenchmark (effect, options, options.sampleRates[i], options.blockSizes[j], true));
+                numAccumulatingAllocations += r.numAllocations;
+                printResult (r, options.csv);
+            }
+        }
+    }
+
+    dispatch (effect, effClose);
+
+    if (numAccumulatingAllocations > 0)
+    {
+        fprintf (stderr, "process() made %ld allocations on the audio thread\n", numAccumulatingAllocations);
+        return 2;
+    }
+
+    return 0;
+}
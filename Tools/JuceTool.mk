@@ -0,0 +1,58 @@
+# Shared rules for the command-line tools that link the plugin's processor
+# with JUCE directly, rather than loading it as a plugin.
+#
+# A tool's Makefile sets TARGET and TOOL_SOURCES, then includes this file.
+# Set JUCE_MODULES if the JUCE modules aren't where the Introjucer project
+# expects them, and CONFIG=Debug for a debug build.
+
+ifndef CONFIG
+  CONFIG=Release
+endif
+
+JUCE_MODULES ?= ../../../../Documents/Developement/juce_source/juce/modules
+
+MODULES := juce_audio_basics juce_audio_devices juce_audio_formats juce_audio_processors \
+           juce_core juce_data_structures juce_events juce_graphics juce_gui_basics juce_gui_extra
+
+# everything in Source apart from the plugin wrappers
+PLUGIN_SOURCES := $(filter-out %_WrapperExt.cpp, $(wildcard ../../Source/*.cpp))
+
+CPPFLAGS += -MMD -D "LINUX=1" -I "/usr/include/freetype2" -I "../../JuceLibraryCode" -I "../../Source"
+LDFLAGS += -lfreetype -lpthread -lrt -ldl -lX11 -lGL -lGLU -lXinerama -lasound
+
+ifeq ($(CONFIG),Debug)
+  CPPFLAGS += -D "DEBUG=1" -D "_DEBUG=1"
+  CXXFLAGS += -g -ggdb -O0
+else
+  CPPFLAGS += -D "NDEBUG=1"
+  CXXFLAGS += -O3
+endif
+
+OUTDIR := build
+OBJDIR := build/intermediate/$(CONFIG)
+
+vpath %.cpp . ../../Source $(addprefix $(JUCE_MODULES)/, $(MODULES))
+
+OBJECTS := $(addprefix $(OBJDIR)/, $(notdir $(TOOL_SOURCES:.cpp=.o)) \
+                                   $(notdir $(PLUGIN_SOURCES:.cpp=.o)) \
+                                   $(addsuffix .o, $(MODULES)))
+
+.PHONY: all clean
+
+all: $(OUTDIR)/$(TARGET)
+
+$(OUTDIR)/$(TARGET): $(OBJECTS)
+	-@mkdir -p $(OUTDIR)
+	@echo "Linking $(TARGET)"
+	@$(CXX) -o $@ $(OBJECTS) $(LDFLAGS)
+
+$(OBJDIR)/%.o: %.cpp
+	-@mkdir -p $(OBJDIR)
+	@echo "Compiling $(notdir $<)"
+	@$(CXX) $(CPPFLAGS) $(CXXFLAGS) -o "$@" -c "$<"
+
+clean:
+	@echo "Cleaning $(TARGET)"
+	-@rm -rf $(OUTDIR)
+
+-include $(OBJECTS:%.o=%.d)
@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+
+    A command-line renderer that runs audio files through the plugin's
+    processor without a host.
+
+    The processor is created with createPluginFilter(), put into offline mode,
+    and fed a WAV file in large blocks, with parameter changes read from an
+    automation script. It reports how fast the processing ran, can write the
+    result, and can compare it with a golden file so DSP changes can be checked
+    for bit-exact output.
+
+    Run it with no arguments to see the options.
+
+  ==============================================================================
+*/
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "juce_AudioProcessorExt.h"
+
+extern AudioProcessorExt* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    //==============================================================================
+    struct Options
+    {
+        Options() : blockSize (8192), tolerance (0.0f) {}
+
+        File inputFile, outputFile, automationFile, goldenFile;
+        int blockSize;
+        float tolerance;
+    };
+
+    /** A parameter change read from an automation script. */
+    struct AutomationPoint
+    {
+        int64 time;             // in samples
+        int parameterIndex;
+        float value;            // full-scale
+        int rampLength;         // in samples, or 0 to jump
+
+        static int compareElements (const AutomationPoint& first, const AutomationPoint& second) noexcept
+        {
+            return first.time < second.time ? -1 : (first.time > second.time ? 1 : 0);
+        }
+    };
+
+    //==============================================================================
+    int findParameter (AudioProcessorExt& filter, const String& name)
+    {
+        if (name.containsOnly ("0123456789"))
+            return isPositiveAndBelow (name.getIntValue(), filter.getNumParameters()) ? name.getIntValue() : -1;
+
+        const int index = filter.getParameterIndexForIdentifier (name);
+
+        if (index >= 0)
+            return index;
+
+        for (int i = 0; i < filter.getNumParameters(); ++i)
+            if (filter.getParameterName (i) == name)
+                return i;
+
+        return -1;
+    }
+
+    /** Reads an automation script. Each line has a time in seconds, a parameter
+        index, identifier or name, the new full-scale value, and optionally the
+        time in seconds to ramp to it over:
+
+            0.0   gain   1.0
+            2.5   gain   0.25   0.5     # ramps down over half a second
+    */
+    bool readAutomation (const File& file, AudioProcessorExt& filter, const double sampleRate,
+                         Array<AutomationPoint>& points, String& error)
+    {
+        StringArray lines;
+        lines.addLines (file.loadFileAsString());
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            StringArray tokens;
+            tokens.addTokens (lines[i].upToFirstOccurrenceOf ("#", false, false), " \t", String::empty);
+            tokens.removeEmptyStrings();
+
+            if (tokens.size() == 0)
+                continue;
+
+            AutomationPoint point;
+            point.parameterIndex = tokens.size() >= 3 ? findParameter (filter, tokens[1]) : -1;
+
+            if (point.parameterIndex < 0 || tokens.size() > 4)
+            {
+                error = file.getFileName() + " line " + String (i + 1) + ": can't read \"" + lines[i].trim() + "\"";
+                return false;
+            }
+
+            point.time = (int64) (tokens[0].getDoubleValue() * sampleRate + 0.5);
+            point.value = tokens[2].getFloatValue();
+            point.rampLength = tokens.size() > 3 ? (int) (tokens[3].getDoubleValue() * sampleRate + 0.5) : 0;
+            points.add (point);
+        }
+
+        AutomationPoint sorter;
+        points.sort (sorter, true);
+        return true;
+    }
+
+    /** Passes the points that fall in a block to the filter, at the sample they
+        belong to if it can schedule changes, or at the start of the block if not.
+    */
+    void applyAutomation (AudioProcessorExt& filter, const Array<AutomationPoint>& points, int& nextPoint,
+                          const int64 blockStart, const int numSamples)
+    {
+        for (; nextPoint < points.size(); ++nextPoint)
+        {
+            const AutomationPoint& p = points.getReference (nextPoint);
+
+            if (p.time >= blockStart + numSamples)
+                break;
+
+            const int offset = (int) jmax ((int64) 0, p.time - blockStart);
+
+            const bool wasScheduled = p.rampLength > 0
+                ? filter.scheduleParameterRamp (p.parameterIndex, filter.getScaledParameter (p.parameterIndex),
+                                                p.value, offset, p.rampLength)
+                : filter.scheduleParameterChange (p.parameterIndex, p.value, offset);
+
+            if (! wasScheduled)
+                filter.setScaledParameter (p.parameterIndex, p.value);
+        }
+    }
+
+    //==============================================================================
+    /** Reads a block of any number of channels from a file as floats. */
+    void readBlock (AudioFormatReader& reader, AudioSampleBuffer& buffer, const int64 startSample, const int numSamples)
+    {
+        reader.read (reinterpret_cast<int**> (buffer.getArrayOfChannels()), buffer.getNumChannels(),
+                     startSample, numSamples, false);
+
+        if (! reader.usesFloatingPointData)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                float* const data = buffer.getSampleData (ch);
+
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = reinterpret_cast<const int*> (data)[i] * (1.0f / 0x7fffffff);
+            }
+        }
+    }
+
+    /** Keeps track of how far the output is from a golden file. */
+    struct Comparison
+    {
+        Comparison() : numDifferent (0), maxDifference (0.0f), firstDifference (-1), firstChannel (0) {}
+
+        void compare (const AudioSampleBuffer& output, const AudioSampleBuffer& golden,
+                      const int64 blockStart, const int numSamples, const float tolerance)
+        {
+            for (int ch = 0; ch < output.getNumChannels(); ++ch)
+            {
+                const float* const a = output.getSampleData (ch);
+                const float* const b = golden.getSampleData (ch);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float difference = std::abs (a[i] - b[i]);
+
+                    // compared with != too, so a NaN can't slip through
+                    if (difference > tolerance || (tolerance == 0.0f && a[i] != b[i]))
+                    {
+                        if (firstDifference < 0 || blockStart + i < firstDifference)
+                        {
+                            firstDifference = blockStart + i;
+                            firstChannel = ch;
+                        }
+
+                        ++numDifferent;
+                        maxDifference = jmax (maxDifference, difference);
+                    }
+                }
+            }
+        }
+
+        int64 numDifferent;
+        float maxDifference;
+        int64 firstDifference;
+        int firstChannel;
+    };
+
+    //==============================================================================
+    bool parseOptions (const StringArray& args, Options& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const String& arg = args[i];
+            const String next (args[i + 1]);
+
+            if (next.isEmpty())
+                return false;
+
+            ++i;
+
+            if (arg == "-i")                    options.inputFile = File::getCurrentWorkingDirectory().getChildFile (next);
+            else if (arg == "-o")               options.outputFile = File::getCurrentWorkingDirectory().getChildFile (next);
+            else if (arg == "-a")               options.automationFile = File::getCurrentWorkingDirectory().getChildFile (next);
+            else if (arg == "--compare")        options.goldenFile = File::getCurrentWorkingDirectory().getChildFile (next);
+            else if (arg == "--tolerance")      options.tolerance = next.getFloatValue();
+            else if (arg == "-b")               options.blockSize = next.getIntValue();
+            else                                return false;
+        }
+
+        return options.inputFile != File::nonexistent && options.blockSize > 0;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: OfflineRender -i input.wav [options]" << std::endl << std::endl
+                  << "  -o output.wav              write the result as a 32-bit float WAV file" << std::endl
+                  << "  -a automation.txt          apply the parameter changes in a script" << std::endl
+                  << "  -b 8192                    the block size to process in" << std::endl
+                  << "  --compare golden.wav       check the result against an earlier render" << std::endl
+                  << "  --tolerance 0              the largest difference allowed, 0 for bit-exact" << std::endl << std::endl
+                  << "Each line of an automation script has a time in seconds, a parameter" << std::endl
+                  << "index, identifier or name, a full-scale value, and optionally a ramp time" << std::endl
+                  << "in seconds, e.g. \"2.5 gain 0.25 0.5\". Anything after a # is ignored." << std::endl;
+    }
+
+    int fail (const String& message)
+    {
+        std::cerr << message << std::endl;
+        return 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add (CharPointer_UTF8 (argv[i]));
+
+    Options options;
+
+    if (! parseOptions (args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    ScopedPointer<AudioFormatReader> reader (formatManager.createReaderFor (options.inputFile));
+
+    if (reader == nullptr)
+        return fail ("Couldn't read " + options.inputFile.getFullPathName());
+
+    const int numChannels = (int) reader->numChannels;
+    const double sampleRate = reader->sampleRate;
+    const int64 length = reader->lengthInSamples;
+    const int blockSize = options.blockSize;
+
+    ScopedPointer<AudioProcessorExt> filter (createPluginFilter());
+
+    if (filter == nullptr)
+        return fail ("createPluginFilter() didn't create a processor");
+
+    Array<AutomationPoint> automation;
+    String error;
+
+    if (options.automationFile != File::nonexistent
+         && ! readAutomation (options.automationFile, *filter, sampleRate, automation, error))
+        return fail (error);
+
+    ScopedPointer<AudioFormatReader> goldenReader;
+
+    if (options.goldenFile != File::nonexistent)
+    {
+        goldenReader = formatManager.createReaderFor (options.goldenFile);
+
+        if (goldenReader == nullptr)
+            return fail ("Couldn't read " + options.goldenFile.getFullPathName());
+
+        if ((int) goldenReader->numChannels != numChannels || goldenReader->lengthInSamples != length)
+            return fail (options.goldenFile.getFileName() + " doesn't have the same length and number of channels as the input");
+    }
+
+    ScopedPointer<AudioFormatWriter> writer;
+
+    if (options.outputFile != File::nonexistent)
+    {
+        options.outputFile.deleteFile();
+        ScopedPointer<FileOutputStream> out (options.outputFile.createOutputStream());
+
+        if (out != nullptr)
+            writer = WavAudioFormat().createWriterFor (out, sampleRate, (unsigned int) numChannels, 32, StringPairArray(), 0);
+
+        if (writer == nullptr)
+            return fail ("Couldn't write " + options.outputFile.getFullPathName());
+
+        out.release();  // the writer owns it now
+    }
+
+    // render like a host bouncing offline would
+    filter->setNonRealtime (true);
+    filter->setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+    filter->prepareToPlay (sampleRate, blockSize);
+
+    AudioSampleBuffer buffer (numChannels, blockSize), goldenBuffer (numChannels, blockSize);
+    MidiBuffer midiMessages;
+    Comparison comparison;
+    int nextPoint = 0;
+    double processingTime = 0.0;
+
+    for (int64 pos = 0; pos < length; pos += blockSize)
+    {
+        const int numSamples = (int) jmin ((int64) blockSize, length - pos);
+
+        readBlock (*reader, buffer, pos, numSamples);
+        AudioSampleBuffer block (buffer.getArrayOfChannels(), numChannels, numSamples);
+
+        const int64 startTime = Time::getHighResolutionTicks();
+
+        {
+            const ScopedLock sl (filter->getCallbackLock());
+            applyAutomation (*filter, automation, nextPoint, pos, numSamples);
+            filter->processBlock (block, midiMessages);
+        }
+
+        processingTime += Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTime);
+        midiMessages.clear();
+
+        if (writer != nullptr)
+            writer->writeFromAudioSampleBuffer (block, 0, numSamples);
+
+        if (goldenReader != nullptr)
+        {
+            readBlock (*goldenReader, goldenBuffer, pos, numSamples);
+            comparison.compare (block, goldenBuffer, pos, numSamples, options.tolerance);
+        }
+    }
+
+    filter->releaseResources();
+    writer = nullptr;
+
+    const double seconds = length / sampleRate;
+
+    std::cout << "Rendered " << String (seconds, 2) << " s of " << numChannels << " channel audio at "
+              << sampleRate << " Hz in " << blockSize << " sample blocks" << std::endl;
+
+    if (processingTime > 0.0)
+        std::cout << "Processing took " << String (processingTime, 3) << " s: "
+                  << (int64) (length / processingTime) << " samples per second, "
+                  << String (seconds / processingTime, 1) << "x real-time" << std::endl;
+
+    if (goldenReader != nullptr)
+    {
+        if (comparison.numDifferent == 0)
+        {
+            std::cout << "Matches " << options.goldenFile.getFileName() << std::endl;
+        }
+        else
+        {
+            std::cout << "Differs from " << options.goldenFile.getFileName() << " in " << comparison.numDifferent
+                      << " samples, by up to " << comparison.maxDifference << ", first at sample "
+                      << comparison.firstDifference << " of channel " << comparison.firstChannel << std::endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,875 @@
+/*
+  ==============================================================================
+
+    Microbenchmarks for the parameter code and the other real-time helpers.
+
+    Each PluginParameter benchmark runs over sets of 1, 100 and 10,000
+    parameters, and the contended variants run the same operations while
+    another thread writes to the parameters the way host automation does.
+    The interleaving kernels are checked against plain loops before
+    they're timed, and the tool fails if they don't match. The MidiEventFifo
+    test pushes a million events through the AU wrapper's MIDI FIFO from another
+    thread and fails if any are lost or damaged. Results are given as
+    nanoseconds per parameter (or per sample, event, etc.), and --csv prints
+    them in a form that can be tracked across commits.
+
+    Run it with --help to see the options.
+
+  ==============================================================================
+*/
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "juce_PluginParameter.h"
+#include "juce_PluginParameterState.h"
+#include "juce_AudioInterleaving.h"
+#include "juce_MidiEventFifo.h"
+
+namespace
+{
+    // results are added to this so the compiler can't throw the work away
+    volatile double sink = 0.0;
+
+    double minSecondsPerTest = 0.25;
+
+    //==============================================================================
+    void createParameters (OwnedArray<PluginParameter>& parameters, const int numParameters)
+    {
+        const ParameterUnit units[] = { UnitGeneric, UnitDecibels, UnitHertz, UnitPercent, UnitMilliseconds };
+
+        parameters.clear();
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            PluginParameter* const p = new PluginParameter();
+            p->init ("Parameter " + String (i), units [i % numElementsInArray (units)], "A parameter",
+                     0.5, 0.0, 1.0, 0.5, 1.0, 0.1, 0.001);
+            p->setIdentifier ("param" + String (i));
+            parameters.add (p);
+        }
+    }
+
+    /** Gives every parameter its own value, as a real preset would, so the
+        compressed state isn't flattered by a run of identical entries. The
+        seed is fixed so the sizes and times can be compared between runs.
+    */
+    void randomiseValues (OwnedArray<PluginParameter>& parameters)
+    {
+        Random random (4321);
+
+        for (int i = 0; i < parameters.size(); ++i)
+            parameters.getUnchecked (i)->setNormalisedValue (random.nextDouble());
+    }
+
+    //==============================================================================
+    /** A single benchmark, which does something to every parameter in a set. */
+    class Benchmark
+    {
+    public:
+        Benchmark (const String& name_, const String& variant_)  : name (name_), variant (variant_) {}
+        virtual ~Benchmark() {}
+
+        /** Called before timing starts. */
+        virtual void prepare (OwnedArray<PluginParameter>&) {}
+
+        /** Does one pass over the whole set, which counts as one operation per parameter. */
+        virtual void run (OwnedArray<PluginParameter>& parameters) = 0;
+
+        /** Called after timing has finished. */
+        virtual void finish() {}
+
+        /** Returns any size worth reporting alongside the time, e.g. the size of some saved state. */
+        virtual int getNumBytes() const     { return 0; }
+
+        const String name, variant;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (Benchmark);
+    };
+
+    //==============================================================================
+    struct GetValue  : public Benchmark
+    {
+        GetValue() : Benchmark ("getValue", "uncontended") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            double total = 0.0;
+
+            for (int i = 0; i < parameters.size(); ++i)
+                total += parameters.getUnchecked (i)->getValue();
+
+            sink = sink + total;
+        }
+    };
+
+    struct SetNormalisedValue  : public Benchmark
+    {
+        SetNormalisedValue() : Benchmark ("setNormalisedValue", "uncontended"), counter (0) {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            const double value = (++counter & 255) / 255.0;
+
+            for (int i = 0; i < parameters.size(); ++i)
+                parameters.getUnchecked (i)->setNormalisedValue (value);
+        }
+
+        int counter;
+    };
+
+    struct Smooth  : public Benchmark
+    {
+        Smooth() : Benchmark ("smooth", "uncontended"), counter (0) {}
+
+        /** The target moves on every run, as it would while being automated, so
+            smooth() always has a step to take rather than returning straight away.
+            This means the time includes setting each target.
+        */
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            const double target = (++counter & 255) / 255.0;
+            double total = 0.0;
+
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                PluginParameter* const p = parameters.getUnchecked (i);
+                p->setNormalisedValue (target);
+                p->smooth();
+                total += p->getSmoothedValue();
+            }
+
+            sink = sink + total;
+        }
+
+        int counter;
+    };
+
+    struct GetParameterText  : public Benchmark
+    {
+        GetParameterText() : Benchmark ("getParameterText", "String") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            int total = 0;
+
+            for (int i = 0; i < parameters.size(); ++i)
+                total += parameters.getUnchecked (i)->getText().length();
+
+            sink = sink + total;
+        }
+    };
+
+    struct CopyTextUTF8  : public Benchmark
+    {
+        CopyTextUTF8() : Benchmark ("getParameterText", "copyTextUTF8") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            char text [PluginParameterText::maxLength];
+            int total = 0;
+
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                parameters.getUnchecked (i)->copyTextUTF8 (text, sizeof (text));
+                total += text[0];
+            }
+
+            sink = sink + total;
+        }
+    };
+
+    //==============================================================================
+    struct WriteXml  : public Benchmark
+    {
+        WriteXml() : Benchmark ("writeXml", String::empty) {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            XmlElement xml ("STATE");
+
+            for (int i = 0; i < parameters.size(); ++i)
+                parameters.getUnchecked (i)->writeXml (xml);
+
+            sink = sink + xml.getNumAttributes();
+        }
+    };
+
+    struct ReadXml  : public Benchmark
+    {
+        ReadXml() : Benchmark ("readXml", String::empty), xml ("STATE") {}
+
+        void prepare (OwnedArray<PluginParameter>& parameters)
+        {
+            for (int i = 0; i < parameters.size(); ++i)
+                parameters.getUnchecked (i)->writeXml (xml);
+        }
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            for (int i = 0; i < parameters.size(); ++i)
+                parameters.getUnchecked (i)->readXml (&xml);
+        }
+
+        XmlElement xml;
+    };
+
+    //==============================================================================
+    struct WriteBinaryState  : public Benchmark
+    {
+        WriteBinaryState (bool shouldCompress_)
+            : Benchmark ("writeBinaryState", shouldCompress_ ? "compressed" : "uncompressed"),
+              shouldCompress (shouldCompress_)
+        {
+        }
+
+        void prepare (OwnedArray<PluginParameter>& parameters)
+        {
+            randomiseValues (parameters);
+        }
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            PluginParameterState::write (parameters, data, shouldCompress);
+        }
+
+        int getNumBytes() const     { return (int) data.getSize(); }
+
+        const bool shouldCompress;
+        juce::MemoryBlock data;
+    };
+
+    struct ReadBinaryState  : public Benchmark
+    {
+        ReadBinaryState (bool shouldCompress_)
+            : Benchmark ("readBinaryState", shouldCompress_ ? "compressed" : "uncompressed"),
+              shouldCompress (shouldCompress_)
+        {
+        }
+
+        void prepare (OwnedArray<PluginParameter>& parameters)
+        {
+            randomiseValues (parameters);
+            PluginParameterState::write (parameters, data, shouldCompress);
+        }
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            PluginParameterState::read (data.getData(), (int) data.getSize(), parameters);
+        }
+
+        int getNumBytes() const     { return (int) data.getSize(); }
+
+        const bool shouldCompress;
+        juce::MemoryBlock data;
+    };
+
+    //==============================================================================
+    /** Makes a copy of the whole set, as a processor does when it creates a program. */
+    struct CopyParameters  : public Benchmark
+    {
+        CopyParameters() : Benchmark ("copyParameters", "copy constructor") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            OwnedArray<PluginParameter> copies;
+            copies.ensureStorageAllocated (parameters.size());
+
+            for (int i = 0; i < parameters.size(); ++i)
+                copies.add (new PluginParameter (*parameters.getUnchecked (i)));
+
+            sink = sink + copies.size();
+        }
+    };
+
+    struct CopyParameterValues  : public Benchmark
+    {
+        CopyParameterValues() : Benchmark ("copyParameters", "copyValueFrom") {}
+
+        void prepare (OwnedArray<PluginParameter>& parameters)
+        {
+            for (int i = 0; i < parameters.size(); ++i)
+                others.add (new PluginParameter (*parameters.getUnchecked (i)));
+        }
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            for (int i = 0; i < parameters.size(); ++i)
+                parameters.getUnchecked (i)->copyValueFrom (*others.getUnchecked (i));
+        }
+
+        OwnedArray<PluginParameter> others;
+    };
+
+   #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+    //==============================================================================
+    /** Moves each parameter out and back again, reading the moved-from one in between. */
+    struct MoveParameters  : public Benchmark
+    {
+        MoveParameters() : Benchmark ("moveParameters", "move constructor") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            for (int i = 0; i < parameters.size(); ++i)
+            {
+                PluginParameter& p = *parameters.getUnchecked (i);
+                PluginParameter moved (static_cast<PluginParameter&&> (p));
+                sink = sink + p.getValue();
+
+                p = static_cast<PluginParameter&&> (moved);
+                sink = sink + moved.getValue();
+            }
+        }
+    };
+
+    /** Reverses the order of the parameters' contents using moves, as a
+        processor does when the user rearranges some slots.
+     */
+    struct RearrangeParameters  : public Benchmark
+    {
+        RearrangeParameters() : Benchmark ("moveParameters", "rearrange") {}
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            const int numParameters = parameters.size();
+
+            for (int i = 0; i < numParameters / 2; ++i)
+            {
+                PluginParameter& a = *parameters.getUnchecked (i);
+                PluginParameter& b = *parameters.getUnchecked (numParameters - 1 - i);
+
+                PluginParameter temp (static_cast<PluginParameter&&> (a));
+                a = static_cast<PluginParameter&&> (b);
+                b = static_cast<PluginParameter&&> (temp);
+            }
+
+            sink = sink + parameters.getUnchecked (0)->getValue();
+        }
+    };
+   #endif
+
+    //==============================================================================
+    /** Keeps changing every parameter in a set from a background thread, like a host
+        sending automation from its own thread while the audio thread reads them.
+        PluginParameter holds its value atomically, so this is safe to do.
+    */
+    class AutomationThread  : public Thread
+    {
+    public:
+        AutomationThread (OwnedArray<PluginParameter>& parameters_)
+            : Thread ("Automation"), parameters (parameters_)
+        {
+        }
+
+        void run()
+        {
+            for (int counter = 0; ! threadShouldExit(); ++counter)
+            {
+                const double value = (counter & 255) / 255.0;
+
+                for (int i = 0; i < parameters.size(); ++i)
+                    parameters.getUnchecked (i)->setNormalisedValue (value);
+            }
+        }
+
+    private:
+        OwnedArray<PluginParameter>& parameters;
+
+        JUCE_DECLARE_NON_COPYABLE (AutomationThread);
+    };
+
+    /** Runs another benchmark while an AutomationThread is writing to the same set. */
+    struct Contended  : public Benchmark
+    {
+        Contended (Benchmark* benchmark_)
+            : Benchmark (benchmark_->name, "contended"), benchmark (benchmark_)
+        {
+        }
+
+        void prepare (OwnedArray<PluginParameter>& parameters)
+        {
+            benchmark->prepare (parameters);
+            writer = new AutomationThread (parameters);
+            writer->startThread();
+        }
+
+        void run (OwnedArray<PluginParameter>& parameters)
+        {
+            benchmark->run (parameters);
+        }
+
+        void finish()
+        {
+            writer->stopThread (1000);
+            writer = nullptr;
+            benchmark->finish();
+        }
+
+        ScopedPointer<Benchmark> benchmark;
+        ScopedPointer<AutomationThread> writer;
+    };
+
+    //==============================================================================
+    struct Result
+    {
+        String name, variant;
+        int size;
+        double nanosecondsPerOp;
+        int numBytes;
+    };
+
+    /** Runs a benchmark enough times to take at least minSecondsPerTest. */
+    double timeRuns (Benchmark& benchmark, OwnedArray<PluginParameter>& parameters)
+    {
+        benchmark.run (parameters);   // warm up
+
+        for (int64 numRuns = 1;;)
+        {
+            const int64 start = Time::getHighResolutionTicks();
+
+            for (int64 i = 0; i < numRuns; ++i)
+                benchmark.run (parameters);
+
+            const double elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            if (elapsed >= minSecondsPerTest)
+                return elapsed / numRuns;
+
+            numRuns *= (elapsed > minSecondsPerTest / 100.0) ? (int64) (minSecondsPerTest / elapsed) + 1 : 100;
+        }
+    }
+
+    Result runParameterBenchmark (Benchmark* benchmarkToRun, const int numParameters)
+    {
+        ScopedPointer<Benchmark> benchmark (benchmarkToRun);
+
+        OwnedArray<PluginParameter> parameters;
+        createParameters (parameters, numParameters);
+
+        benchmark->prepare (parameters);
+        const double secondsPerRun = timeRuns (*benchmark, parameters);
+        benchmark->finish();
+
+        Result r;
+        r.name = benchmark->name;
+        r.variant = benchmark->variant;
+        r.size = numParameters;
+        r.nanosecondsPerOp = secondsPerRun * 1.0e9 / numParameters;
+        r.numBytes = benchmark->getNumBytes();
+        return r;
+    }
+
+    //==============================================================================
+    /** Times the vectorised interleaving against a plain loop, per sample. */
+    Result runInterleaveBenchmark (const int numChannels, const bool useKernels, const bool isInterleaving)
+    {
+        const int numFrames = 512;
+        HeapBlock<float> interleaved ((size_t) (numChannels * numFrames), true);
+        HeapBlock<float> separate ((size_t) (numChannels * numFrames), true);
+        HeapBlock<float*> channels ((size_t) numChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch] = separate + ch * numFrames;
+
+        int64 numRuns = 0;
+        const int64 start = Time::getHighResolutionTicks();
+        double elapsed = 0.0;
+
+        while (elapsed < minSecondsPerTest)
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (useKernels)
+                {
+                    if (isInterleaving)
+                        AudioInterleaving::interleave (channels, numChannels, interleaved, numChannels, numFrames);
+                    else
+                        AudioInterleaving::deinterleave (interleaved, numChannels, channels, numChannels, numFrames);
+                }
+                else
+                {
+                    // the strided loops the wrappers used before
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        for (int j = 0; j < numFrames; ++j)
+                            if (isInterleaving)
+                                interleaved [j * numChannels + ch] = channels[ch][j];
+                            else
+                                channels[ch][j] = interleaved [j * numChannels + ch];
+                }
+            }
+
+            numRuns += 1000;
+            elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        }
+
+        sink = sink + interleaved[1] + separate[1];
+
+        Result r;
+        r.name = isInterleaving ? "interleave" : "deinterleave";
+        r.variant = useKernels ? "AudioInterleaving" : "scalar loop";
+        r.size = numChannels;
+        r.nanosecondsPerOp = elapsed * 1.0e9 / (numRuns * numFrames * numChannels);
+        r.numBytes = 0;
+        return r;
+    }
+
+    /** Checks the interleaving functions against plain loops for every channel
+        count from 1 to 8, with frames the same size as the channel count and one
+        bigger, and with lengths that aren't a multiple of the vector size.
+        Returns the number of mismatches.
+     */
+    int checkInterleaving()
+    {
+        const int lengths[] = { 0, 1, 3, 4, 5, 7, 8, 13, 64, 509, 512 };
+        const int maxLength = 512, maxChannels = 9;
+
+        HeapBlock<float> interleaved ((size_t) (maxChannels * maxLength)), expected ((size_t) (maxChannels * maxLength));
+        HeapBlock<float> separate ((size_t) (maxChannels * maxLength)), roundTrip ((size_t) (maxChannels * maxLength));
+        HeapBlock<float*> channels ((size_t) maxChannels), roundTripChannels ((size_t) maxChannels);
+        Random random (1234);
+        int numErrors = 0;
+
+        for (int numChannels = 1; numChannels <= 8; ++numChannels)
+        {
+            for (int numFrameChannels = numChannels; numFrameChannels <= numChannels + 1; ++numFrameChannels)
+            {
+                for (int l = 0; l < numElementsInArray (lengths); ++l)
+                {
+                    const int numSamples = lengths[l];
+                    const int numFloats = numFrameChannels * maxLength;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        channels[ch] = separate + ch * maxLength;
+                        roundTripChannels[ch] = roundTrip + ch * maxLength;
+                    }
+
+                    for (int i = 0; i < maxChannels * maxLength; ++i)
+                        separate[i] = random.nextFloat() - 0.5f;
+
+                    for (int i = 0; i < numFloats; ++i)
+                        interleaved[i] = expected[i] = random.nextFloat() - 0.5f;
+
+                    // interleave, leaving any unused channels in each frame alone
+                    for (int i = 0; i < numSamples; ++i)
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            expected [i * numFrameChannels + ch] = channels[ch][i];
+
+                    AudioInterleaving::interleave (channels, numChannels, interleaved, numFrameChannels, numSamples);
+                    const bool interleavedOk = memcmp (interleaved, expected, sizeof (float) * (size_t) numFloats) == 0;
+
+                    // and back again, which should give the original channels
+                    AudioInterleaving::deinterleave (interleaved, numFrameChannels, roundTripChannels, numChannels, numSamples);
+                    bool roundTripOk = true;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        roundTripOk = roundTripOk && memcmp (roundTripChannels[ch], channels[ch], sizeof (float) * (size_t) numSamples) == 0;
+
+                    // adding on top of what's there
+                    for (int i = 0; i < numSamples; ++i)
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            expected [i * numFrameChannels + ch] += channels[ch][i];
+
+                    AudioInterleaving::interleaveAdding (channels, numChannels, interleaved, numFrameChannels, numSamples);
+                    const bool addingOk = memcmp (interleaved, expected, sizeof (float) * (size_t) numFloats) == 0;
+
+                    const char* const failures[] = { interleavedOk ? nullptr : "interleave",
+                                                     roundTripOk ? nullptr : "deinterleave",
+                                                     addingOk ? nullptr : "interleaveAdding" };
+
+                    for (int i = 0; i < numElementsInArray (failures); ++i)
+                    {
+                        if (failures[i] != nullptr)
+                        {
+                            std::cerr << failures[i] << " is wrong for " << numChannels << " of " << numFrameChannels
+                                      << " channels and " << numSamples << " samples!" << std::endl;
+                            ++numErrors;
+                        }
+                    }
+                }
+            }
+        }
+
+        return numErrors;
+    }
+
+    //==============================================================================
+    /** Pushes MIDI from one thread while another pops it, checking that every event
+        arrives in order and intact.
+    */
+    class MidiProducerThread  : public Thread
+    {
+    public:
+        MidiProducerThread (MidiEventFifo& fifo_, int numEvents_)
+            : Thread ("MIDI producer"), fifo (fifo_), numEvents (numEvents_)
+        {
+        }
+
+        /** Every 17th event is sysex, and the rest are note-ons. */
+        static int getEventSize (int index) noexcept
+        {
+            return (index % 17 == 0) ? 10 + index % 90 : 3;
+        }
+
+        static uint8 getEventByte (int index, int byte) noexcept
+        {
+            const int size = getEventSize (index);
+
+            if (byte == 0)
+                return (uint8) (size == 3 ? 0x90 | (index & 15) : 0xf0);
+
+            if (size > 3 && byte == size - 1)
+                return 0xf7;
+
+            return (uint8) ((index * 7 + byte) & 0x7f);
+        }
+
+        void run()
+        {
+            uint8 data [100];
+
+            for (int i = 0; i < numEvents && ! threadShouldExit();)
+            {
+                const int size = getEventSize (i);
+
+                for (int j = 0; j < size; ++j)
+                    data[j] = getEventByte (i, j);
+
+                // all at the same position, as a MidiBuffer sorts its events by time
+                if (fifo.push (data, size, 0))
+                    ++i;
+                else
+                    Thread::yield();
+            }
+        }
+
+    private:
+        MidiEventFifo& fifo;
+        const int numEvents;
+
+        JUCE_DECLARE_NON_COPYABLE (MidiProducerThread);
+    };
+
+    Result runMidiFifoStressTest (const int numEvents, int& numErrors)
+    {
+        MidiEventFifo fifo (256, 4096);
+        MidiProducerThread producer (fifo, numEvents);
+        MidiBuffer buffer;
+        buffer.ensureSize (8192);
+
+        const int64 start = Time::getHighResolutionTicks();
+        producer.startThread();
+
+        int nextExpected = 0;
+
+        while (nextExpected < numEvents && (producer.isThreadRunning() || fifo.getNumReady() > 0))
+        {
+            buffer.clear();
+            fifo.popAll (buffer, 512);
+
+            MidiBuffer::Iterator iter (buffer);
+            const uint8* data;
+            int size, position;
+
+            while (iter.getNextEvent (data, size, position))
+            {
+                bool isIntact = size == MidiProducerThread::getEventSize (nextExpected) && position == 0;
+
+                for (int j = 0; j < size && isIntact; ++j)
+                    isIntact = data[j] == MidiProducerThread::getEventByte (nextExpected, j);
+
+                if (! isIntact)
+                    ++numErrors;
+
+                ++nextExpected;
+            }
+        }
+
+        const double elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        producer.stopThread (1000);
+
+        numErrors += numEvents - nextExpected;
+
+        Result r;
+        r.name = "MidiEventFifo";
+        r.variant = "stress";
+        r.size = numEvents;
+        r.nanosecondsPerOp = elapsed * 1.0e9 / numEvents;
+        r.numBytes = 0;
+        return r;
+    }
+
+    //==============================================================================
+    void printResult (const Result& r, const bool csv)
+    {
+        if (csv)
+        {
+            std::cout << r.name << "," << r.variant << "," << r.size << ","
+                      << String (r.nanosecondsPerOp, 3) << "," << String (1.0e9 / r.nanosecondsPerOp, 0) << ","
+                      << r.numBytes << std::endl;
+        }
+        else
+        {
+            std::cout << r.name.paddedRight (' ', 20) << r.variant.paddedRight (' ', 20)
+                      << String (r.size).paddedLeft (' ', 8)
+                      << String (r.nanosecondsPerOp, 2).paddedLeft (' ', 14)
+                      << (r.numBytes > 0 ? String (r.numBytes).paddedLeft (' ', 12) : String::empty) << std::endl;
+        }
+    }
+
+    bool shouldRun (const StringArray& filters, const String& name)
+    {
+        if (filters.size() == 0)
+            return true;
+
+        for (int i = 0; i < filters.size(); ++i)
+            if (name.containsIgnoreCase (filters[i]))
+                return true;
+
+        return false;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: ParameterBenchmark [options] [names to run]" << std::endl << std::endl
+                  << "  --csv            print the results as comma-separated values" << std::endl
+                  << "  --time 0.25      the minimum time in seconds to spend on each test" << std::endl << std::endl
+                  << "Times are in nanoseconds per parameter, or per sample for the" << std::endl
+                  << "interleaving tests and per event for MidiEventFifo. If any names" << std::endl
+                  << "are given, only the benchmarks containing one of them are run." << std::endl;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool csv = false;
+    StringArray filters;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (CharPointer_UTF8 (argv[i]));
+
+        if (arg == "--csv")
+        {
+            csv = true;
+        }
+        else if (arg == "--time" && i + 1 < argc)
+        {
+            minSecondsPerTest = jmax (0.001, String (argv[++i]).getDoubleValue());
+        }
+        else if (arg.startsWithChar ('-'))
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            filters.add (arg);
+        }
+    }
+
+    if (csv)
+        std::cout << "benchmark,variant,size,nsPerOp,opsPerSecond,bytes" << std::endl;
+    else
+        std::cout << "benchmark           variant                 size     ns per op       bytes" << std::endl;
+
+    const int sizes[] = { 1, 100, 10000 };
+    const char* const names[] = { "getValue", "setNormalisedValue", "smooth", "getParameterText", "writeXml",
+                                  "readXml", "writeBinaryState", "readBinaryState", "copyParameters",
+                                  "moveParameters" };
+
+    for (int n = 0; n < numElementsInArray (names); ++n)
+    {
+        if (! shouldRun (filters, names[n]))
+            continue;
+
+        for (int s = 0; s < numElementsInArray (sizes); ++s)
+        {
+            const int size = sizes[s];
+            const String name (names[n]);
+
+            if (name == "getValue")
+            {
+                printResult (runParameterBenchmark (new GetValue(), size), csv);
+                printResult (runParameterBenchmark (new Contended (new GetValue()), size), csv);
+            }
+            else if (name == "setNormalisedValue")
+            {
+                printResult (runParameterBenchmark (new SetNormalisedValue(), size), csv);
+                printResult (runParameterBenchmark (new Contended (new SetNormalisedValue()), size), csv);
+            }
+            else if (name == "smooth")
+            {
+                printResult (runParameterBenchmark (new Smooth(), size), csv);
+                printResult (runParameterBenchmark (new Contended (new Smooth()), size), csv);
+            }
+            else if (name == "getParameterText")
+            {
+                printResult (runParameterBenchmark (new GetParameterText(), size), csv);
+                printResult (runParameterBenchmark (new CopyTextUTF8(), size), csv);
+                printResult (runParameterBenchmark (new Contended (new CopyTextUTF8()), size), csv);
+            }
+            else if (name == "writeXml")
+            {
+                printResult (runParameterBenchmark (new WriteXml(), size), csv);
+            }
+            else if (name == "readXml")
+            {
+                printResult (runParameterBenchmark (new ReadXml(), size), csv);
+            }
+            else if (name == "writeBinaryState")
+            {
+                printResult (runParameterBenchmark (new WriteBinaryState (false), size), csv);
+                printResult (runParameterBenchmark (new WriteBinaryState (true), size), csv);
+            }
+            else if (name == "readBinaryState")
+            {
+                printResult (runParameterBenchmark (new ReadBinaryState (false), size), csv);
+                printResult (runParameterBenchmark (new ReadBinaryState (true), size), csv);
+            }
+            else if (name == "copyParameters")
+            {
+                printResult (runParameterBenchmark (new CopyParameters(), size), csv);
+                printResult (runParameterBenchmark (new CopyParameterValues(), size), csv);
+            }
+           #if JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS
+            else if (name == "moveParameters")
+            {
+                printResult (runParameterBenchmark (new MoveParameters(), size), csv);
+                printResult (runParameterBenchmark (new RearrangeParameters(), size), csv);
+            }
+           #endif
+        }
+    }
+
+    int numErrors = 0;
+
+    if (shouldRun (filters, "interleave"))
+        numErrors += checkInterleaving();
+
+    const int channelCounts[] = { 2, 4, 8 };
+
+    for (int c = 0; c < numElementsInArray (channelCounts); ++c)
+    {
+        for (int isInterleaving = 0; isInterleaving < 2; ++isInterleaving)
+        {
+            if (shouldRun (filters, isInterleaving ? "interleave" : "deinterleave"))
+            {
+                printResult (runInterleaveBenchmark (channelCounts[c], true, isInterleaving != 0), csv);
+                printResult (runInterleaveBenchmark (channelCounts[c], false, isInterleaving != 0), csv);
+            }
+        }
+    }
+
+    if (shouldRun (filters, "MidiEventFifo"))
+    {
+        printResult (runMidiFifoStressTest (1000000, numErrors), csv);
+
+        if (numErrors > 0)
+            std::cerr << "MidiEventFifo lost or damaged " << numErrors << " events!" << std::endl;
+    }
+
+    return numErrors > 0 ? 1 : 0;
+}